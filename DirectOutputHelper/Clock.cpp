@@ -0,0 +1,86 @@
+#include "Clock.h"
+
+
+
+namespace DOHelper
+{
+
+#pragma region SystemClock
+
+	/*static*/ const SystemClock& SystemClock::Instance()
+	{
+		static const SystemClock instance;
+		return instance;
+	}
+
+
+	TimePoint SystemClock::Now() const
+	{
+		return TimePoint::clock::now();
+	}
+
+
+	std::cv_status SystemClock::WaitUntil(std::condition_variable&		cond,
+										  std::unique_lock<std::mutex>&	lock,
+										  TimePoint						deadline) const
+	{
+		return cond.wait_until(lock, deadline);
+	}
+
+#pragma endregion
+
+
+
+#pragma region VirtualClock
+
+	VirtualClock::VirtualClock(TimePoint start) :
+		ticks { start.time_since_epoch().count() }
+	{
+	}
+
+
+	TimePoint VirtualClock::Now() const
+	{
+		return TimePoint { Duration { ticks.load(std::memory_order_acquire) } };
+	}
+
+
+	void VirtualClock::WarpTo(TimePoint t) const
+	{
+		const TimePoint::rep target = t.time_since_epoch().count();
+
+		TimePoint::rep current = ticks.load(std::memory_order_relaxed);
+		while (current < target && !ticks.compare_exchange_weak(current, target, std::memory_order_acq_rel));
+	}
+
+
+	void VirtualClock::AdvanceTo(TimePoint t)
+	{
+		WarpTo(t);
+	}
+
+
+	void VirtualClock::Advance(Duration d)
+	{
+		WarpTo(Now() + d);
+	}
+
+
+	std::cv_status VirtualClock::WaitUntil(std::condition_variable&		 cond,
+										   std::unique_lock<std::mutex>& lock,
+										   TimePoint					 deadline) const
+	{
+		if (deadline == TimePoint::max())
+		{
+			cond.wait(lock);
+			return std::cv_status::no_timeout;
+		}
+
+		WarpTo(deadline);
+		return std::cv_status::timeout;
+	}
+
+#pragma endregion
+
+
+}	// namespace DOHelper
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "DOHelperTypes.h"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+
+
+
+namespace DOHelper
+{
+
+	/// Source of time for the input processing and the main loops.
+	/// @remarks
+	///	  Everything timed (input stamps, page-change stamps, waits for input) should ask
+	///	  the same IClock, so that a replaced clock affects the whole pipeline consistently.
+	class IClock {
+	public:
+		virtual TimePoint		Now() const = 0;
+
+		/// Blocks on @p cond until notified or @p deadline has been reached according to this clock.
+		/// @param lock:	must own the mutex guarding the state signaled by @p cond
+		virtual std::cv_status	WaitUntil(std::condition_variable&		  cond,
+										  std::unique_lock<std::mutex>&	  lock,
+										  TimePoint						  deadline) const = 0;
+
+		virtual ~IClock() = default;
+	};
+
+
+
+	/// Wall-clock time of TimePoint::clock.
+	class SystemClock final : public IClock {
+	public:
+		static const SystemClock&	Instance();
+
+		TimePoint		Now() const override;
+		std::cv_status	WaitUntil(std::condition_variable&, std::unique_lock<std::mutex>&, TimePoint) const override;
+	};
+
+
+
+	/// Manually driven time for replays, deterministic tests and benchmarks.
+	/// @remarks
+	///	  Waits don't block: time warps forward to their deadline instantly instead,
+	///	  so that loops can run faster than real time.
+	///	  An unbounded wait (TimePoint::max) still blocks until notified.
+	class VirtualClock final : public IClock {
+		mutable std::atomic<TimePoint::rep>	ticks;
+
+		void			WarpTo(TimePoint)		const;
+
+	public:
+		explicit VirtualClock(TimePoint start = {});
+
+		TimePoint		Now() const override;
+		std::cv_status	WaitUntil(std::condition_variable&, std::unique_lock<std::mutex>&, TimePoint) const override;
+
+		/// Step time forward. Never steps backward: earlier TimePoints are ignored.
+		void			AdvanceTo(TimePoint);
+		void			Advance(Duration);
+	};
+
+
+}	// namespace DOHelper
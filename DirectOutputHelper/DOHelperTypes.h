@@ -4,6 +4,22 @@
 #include <cstdint>
 #include <optional>
 
+#ifdef _WIN32
+#	include <winerror.h>
+#else
+	// HRESULTs used by IMfdDevice backends, same values as in winerror.h
+	typedef int32_t HRESULT;
+
+#	define SUCCEEDED(hr)	(((HRESULT)(hr)) >= 0)
+#	define FAILED(hr)		(((HRESULT)(hr)) < 0)
+
+#	define S_OK				((HRESULT)0x00000000L)
+#	define E_FAIL			((HRESULT)0x80004005L)
+#	define E_UNEXPECTED		((HRESULT)0x8000FFFFL)
+#	define E_HANDLE			((HRESULT)0x80070006L)
+#	define E_INVALIDARG		((HRESULT)0x80070057L)
+#endif
+
 
 
 namespace DOHelper
@@ -18,10 +34,13 @@ namespace DOHelper
 	constexpr std::nullopt_t	Nothing = std::nullopt;
 
 
+	class IClock;
+	class IMfdDevice;
 	class DirectOutputInstance;
 	class X52Output;
 	class InputQueue;
 	struct SaiDevice;
+	struct LedBatch;
 	
 	enum class SaiDeviceType;
 	
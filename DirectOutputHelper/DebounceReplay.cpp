@@ -0,0 +1,212 @@
+#include "DebounceReplay.h"
+
+#include "Clock.h"
+#include "InputQueue.h"
+#include "MfdDevice.h"
+#include "Utils/Debug.h"
+#include <algorithm>
+#include <functional>
+#include <istream>
+#include <ostream>
+
+
+
+namespace DOHelper
+{
+	using std::chrono::microseconds;
+
+
+#pragma region Simulated Device
+
+	namespace
+	{
+		/// Time stands still, except waits: they jump to the deadline or to the next message, injecting it.
+		class ReplayClock final : public IClock {
+			const std::vector<InputMessage>&	trace;
+			mutable size_t						next = 0;
+			mutable TimePoint					now;
+
+		public:
+			std::function<void(const InputMessage&)>	Inject;
+
+			explicit ReplayClock(const std::vector<InputMessage>& trace) :
+				trace { trace },
+				now	  { trace.empty() ? TimePoint {} : trace.front().time }
+			{
+			}
+
+			TimePoint Now() const override
+			{
+				return now;
+			}
+
+			// The queue's lock is released while injecting: pushing may notify.
+			std::cv_status WaitUntil(std::condition_variable&,
+									 std::unique_lock<std::mutex>&	lock,
+									 TimePoint						deadline) const override
+			{
+				if (next == trace.size() || deadline < trace[next].time)
+				{
+					now = std::max(now, deadline);
+					return std::cv_status::timeout;
+				}
+
+				lock.unlock();
+				now = trace[next].time;
+				Inject(trace[next++]);
+				lock.lock();
+				return std::cv_status::no_timeout;
+			}
+		};
+
+
+		class ReplayDevice final : public IMfdDevice {
+			const ReplayClock&	clock;
+			PageHandler			pageHandler	   = nullptr;
+			ButtonHandler		buttonHandler  = nullptr;
+			void*				handlerContext = nullptr;
+
+		public:
+			explicit ReplayDevice(const ReplayClock& clock) : clock { clock }
+			{
+			}
+
+			void Raise(const InputMessage& msg)
+			{
+				if (msg.kind == MessageKind::ButtonPress)
+					buttonHandler(Handle(), msg.optData, handlerContext);
+				else
+					pageHandler(Handle(), msg.optData, msg.kind == MessageKind::PageActivated, handlerContext);
+			}
+
+			void*			Handle()		const noexcept override		{ return const_cast<ReplayDevice*>(this); }
+			const IClock&	Clock()			const noexcept override		{ return clock; }
+			bool			IsConnected()	const noexcept override		{ return true; }
+
+			HRESULT	AddPage(uint32_t, bool)									override	{ return S_OK; }
+			HRESULT	RemovePage(uint32_t)									override	{ return S_OK; }
+			HRESULT	SetLed(uint32_t, uint32_t, bool)						override	{ return S_OK; }
+			HRESULT	SetString(uint32_t, uint32_t, uint32_t, const wchar_t*)	override	{ return S_OK; }
+
+			void RegisterInputHandlers(PageHandler onPage, ButtonHandler onButtons, void* context) override
+			{
+				pageHandler	   = onPage;
+				buttonHandler  = onButtons;
+				handlerContext = context;
+			}
+		};
+	}
+
+#pragma endregion
+
+
+
+#pragma region Evaluation
+
+	Duration DebounceReport::MeanLatency() const
+	{
+		const unsigned matched = emitted - spurious;
+		return matched == 0 ? Duration::zero() : totalLatency / matched;
+	}
+
+
+	DebounceReplay::DebounceReplay(uint32_t upMask, uint32_t downMask, uint32_t pressMask) :
+		UpMask	  { upMask },
+		DownMask  { downMask },
+		PressMask { pressMask }
+	{
+	}
+
+
+	auto DebounceReplay::Replay(const std::vector<InputMessage>& trace, const DebounceTiming& timing) const
+		-> std::vector<Emission>
+	{
+		LOGIC_ASSERT_M (trace.size() <= InputQueue::Capacity, "Trace should be split to user actions.");
+
+		ReplayClock			clock  { trace };
+		ReplayDevice		device { clock };
+		InputQueue			queue  { device };
+		ScrollwheelDebounce	debounce { UpMask, DownMask, PressMask, timing };
+
+		clock.Inject = [&device](const InputMessage& msg) { device.Raise(msg); };
+
+		std::vector<Emission> emissions;
+		if (trace.empty())
+			return emissions;
+
+		// enough for any pending decision
+		const TimePoint end = trace.back().time + timing.oppositeDelayLimit + timing.scrollPressCancel;
+
+		while (optional<InputMessage> msg = debounce.Receive(queue, end))
+			emissions.push_back({ *msg, clock.Now() });
+
+		return emissions;
+	}
+
+
+	// Emissions are matched to intended events in order.
+	DebounceReport DebounceReplay::Evaluate(const std::vector<InputTrace>& traces, const DebounceTiming& timing) const
+	{
+		DebounceReport report;
+		for (const InputTrace& trace : traces)
+		{
+			const std::vector<Emission> emissions = Replay(trace.messages, timing);
+			const size_t				matched	  = std::min(emissions.size(), trace.intended.size());
+
+			for (size_t i = 0; i < matched; i++)
+			{
+				const InputMessage& intent = trace.intended[i];
+				const Duration		delay  = emissions[i].at - intent.time;
+
+				report.misclassified += emissions[i].message.optData != intent.optData
+									 || emissions[i].message.kind	 != intent.kind;
+				report.totalLatency  += delay;
+				report.maxLatency	  = std::max(report.maxLatency, delay);
+			}
+
+			report.traces	+= 1;
+			report.expected += static_cast<unsigned>(trace.intended.size());
+			report.emitted	+= static_cast<unsigned>(emissions.size());
+			report.missed	+= static_cast<unsigned>(trace.intended.size() - matched);
+			report.spurious	+= static_cast<unsigned>(emissions.size() - matched);
+		}
+		return report;
+	}
+
+#pragma endregion
+
+
+
+#pragma region Trace IO
+
+	void WriteTrace(std::ostream& os, const std::vector<InputMessage>& trace)
+	{
+		for (const InputMessage& msg : trace)
+		{
+			const auto us = std::chrono::duration_cast<microseconds>(msg.time.time_since_epoch()).count();
+			os << us << ' ' << static_cast<unsigned>(msg.kind) << ' ' << msg.optData << '\n';
+		}
+	}
+
+
+	std::vector<InputMessage> ReadTrace(std::istream& is)
+	{
+		std::vector<InputMessage> trace;
+
+		long long us;
+		unsigned  kind;
+		uint32_t  data;
+		while (is >> us >> kind >> data)
+		{
+			LOGIC_ASSERT_M (kind < static_cast<unsigned>(MessageKind::COUNT), "Invalid message kind in trace.");
+
+			const TimePoint t { std::chrono::duration_cast<Duration>(microseconds { us }) };
+			trace.push_back({ t, static_cast<MessageKind>(kind), data });
+		}
+		return trace;
+	}
+
+#pragma endregion
+
+
+}	// namespace DOHelper
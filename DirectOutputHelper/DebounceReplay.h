@@ -0,0 +1,64 @@
+#pragma once
+
+#include "InputMessage.h"
+#include "ScrollwheelDebounce.h"
+#include <iosfwd>
+#include <vector>
+
+
+
+namespace DOHelper
+{
+
+	/// Raw input of a user action - recorded by InputQueue or synthesized.
+	struct InputTrace {
+		std::vector<InputMessage>	messages;
+		std::vector<InputMessage>	intended;		// what debouncing should emit, stamped with the user's action
+	};
+
+
+	struct DebounceReport {
+		unsigned	traces		  = 0;
+		unsigned	expected	  = 0;
+		unsigned	emitted		  = 0;
+		unsigned	misclassified = 0;		// emitted a different button than intended
+		unsigned	missed		  = 0;
+		unsigned	spurious	  = 0;
+		Duration	totalLatency  = Duration::zero();		// emission - intended action, for matching events
+		Duration	maxLatency	  = Duration::zero();
+
+		Duration	MeanLatency()	const;
+		unsigned	Errors()		const	{ return misclassified + missed + spurious; }
+	};
+
+
+
+	/// Offline evaluation of ScrollwheelDebounce timings.
+	/// @remarks
+	///	  Each trace is fed through a real InputQueue in simulated time: the replay clock
+	///	  injects the next message when the debouncer's wait would have been woken by it,
+	///	  so emission times equal to those of a live run - without waiting.
+	class DebounceReplay {
+	public:
+		struct Emission {
+			InputMessage	message;
+			TimePoint		at;
+		};
+
+		const uint32_t	UpMask;
+		const uint32_t	DownMask;
+		const uint32_t	PressMask;
+
+		DebounceReplay(uint32_t upMask, uint32_t downMask, uint32_t pressMask);
+
+		std::vector<Emission>	Replay(const std::vector<InputMessage>& trace, const DebounceTiming&)		const;
+		DebounceReport			Evaluate(const std::vector<InputTrace>&, const DebounceTiming&)			const;
+	};
+
+
+	/// Text format: a line per message, "<microseconds> <kind> <data>".
+	void						WriteTrace(std::ostream&, const std::vector<InputMessage>&);
+	std::vector<InputMessage>	ReadTrace(std::istream&);
+
+
+}	// namespace DOHelper
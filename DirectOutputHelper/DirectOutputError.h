@@ -1,7 +1,7 @@
 #pragma once
 
+#include "DOHelperTypes.h"
 #include "Utils/Debug.h"
-#include <winerror.h>
 
 
 #define SAI_ASSERT(hr)			HRESULT_ASSERT_BASE	  (DirectOutputError, hr)
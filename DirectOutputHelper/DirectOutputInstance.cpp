@@ -1,6 +1,8 @@
 #include "DirectOutputInstance.h"
 
 #include "DirectOutputError.h"
+#include "MfdDevice.h"
+#include "OutputWorker.h"
 #include "X52Output.h"
 
 #include "Utils/Debug.h"
@@ -261,10 +263,103 @@ namespace DOHelper
 
 
 
+#pragma region Saitek Backend
+
+	/// IMfdDevice backend of a device handle in use, forwarding to the DirectOutput library.
+	class DirectOutputInstance::SaitekX52 final : public IMfdDevice {
+		DirectOutputInstance&	owner;
+		void* const				handle;
+
+		PageHandler				pageHandler	   = nullptr;
+		ButtonHandler			buttonHandler  = nullptr;
+		void*					handlerContext = nullptr;
+
+
+		static void __stdcall OnPageChange(void* dev, DWORD dwPageId, bool activated, void* pCtxt)
+		{
+			auto& self = *reinterpret_cast<SaitekX52*>(pCtxt);
+			self.pageHandler(dev, dwPageId, activated, self.handlerContext);
+		}
+
+		static void __stdcall OnButtonPress(void* dev, DWORD dwButtons, void* pCtxt)
+		{
+			auto& self = *reinterpret_cast<SaitekX52*>(pCtxt);
+			self.buttonHandler(dev, dwButtons, self.handlerContext);
+		}
+
+	public:
+		SaitekX52(DirectOutputInstance& owner, void* handle) :
+			owner  { owner },
+			handle { handle }
+		{
+		}
+
+		~SaitekX52() override
+		{
+			owner.HandleReleased(handle);
+		}
+
+
+		void*			Handle()	  const noexcept override	{ return handle; }
+		const IClock&	Clock()		  const noexcept override	{ return owner.Clock; }
+		bool			IsConnected() const noexcept override	{ return owner.IsConnected(handle); }
+
+
+		HRESULT AddPage(uint32_t pageId, bool setActive) override
+		{
+			return owner.library->AddPage(handle, pageId, nullptr, setActive ? FLAG_SET_AS_ACTIVE : 0);
+		}
+
+
+		HRESULT RemovePage(uint32_t pageId) override
+		{
+			return owner.library->RemovePage(handle, pageId);
+		}
+
+
+		HRESULT SetLed(uint32_t pageId, uint32_t ledId, bool on) override
+		{
+			return owner.library->SetLed(handle, pageId, ledId, on);
+		}
+
+
+		HRESULT SetString(uint32_t pageId, uint32_t line, uint32_t length, const wchar_t* text) override
+		{
+			return owner.library->SetString(handle, pageId, line, length, text);
+		}
+
+
+		// Handlers set before registering, cleared only after unregistering.
+		void RegisterInputHandlers(PageHandler onPage, ButtonHandler onButtons, void* context) override
+		{
+			Saitek::DirectOutput& lib = *owner.library;
+
+			if (onPage == nullptr && onButtons == nullptr)
+			{
+				lib.RegisterPageCallback(handle, nullptr, nullptr);
+				lib.RegisterSoftButtonCallback(handle, nullptr, nullptr);
+			}
+
+			pageHandler	   = onPage;
+			buttonHandler  = onButtons;
+			handlerContext = context;
+
+			if (onPage != nullptr)
+				lib.RegisterPageCallback(handle, &OnPageChange, this);
+			if (onButtons != nullptr)
+				lib.RegisterSoftButtonCallback(handle, &OnButtonPress, this);
+		}
+	};
+
+#pragma endregion
+
+
+
 #pragma region Initialization
 
-	DirectOutputInstance::DirectOutputInstance(const wchar_t *pluginName) :
+	DirectOutputInstance::DirectOutputInstance(const wchar_t *pluginName, const IClock& clock) :
 		PluginName { pluginName },
+		Clock	   { clock },
 		library	   { new Saitek::DirectOutput }
 	{
 		SAI_ASSERT (library->Initialize(pluginName));
@@ -294,11 +389,15 @@ namespace DOHelper
 	}
 
 
-	X52Output	DirectOutputInstance::UseX52(const SaiDevice& device)
+	X52Output	DirectOutputInstance::UseX52(const SaiDevice& device, OutputMode mode)
 	{
 		LOGIC_ASSERT (device.Type == SaiDeviceType::X52Pro);
 
-		X52Output x52 { device.Handle, *this };
+		std::unique_ptr<IMfdDevice> backend = std::make_unique<SaitekX52>(*this, device.Handle);
+		if (mode == OutputMode::Worker)
+			backend = std::make_unique<OutputWorker>(std::move(backend));
+
+		X52Output x52 { std::move(backend) };
 		{
 			std::unique_lock guard { connectionListLock };
 			connections.emplace_front(device.Handle);
@@ -10,6 +10,7 @@
 
 
 #include "DOHelperTypes.h"
+#include "Clock.h"
 #include "Utils/LiteSharedLock.h"
 #include <array>
 #include <future>
@@ -26,6 +27,9 @@ namespace DOHelper
 
 	enum class SaiDeviceType { Unknown, X52Pro, X56Stick, X56Throttle, InstrumentPanel };
 
+	/// How an X52Output issues its commands: on the calling thread or via an OutputWorker.
+	enum class OutputMode { Direct, Worker };
+
 
 	struct SaiDevice {
 		void* const						Handle;
@@ -37,11 +41,10 @@ namespace DOHelper
 
 
 	class DirectOutputInstance {
-		friend class X52Output;
-		friend class InputQueue;
-
 		std::unique_ptr<Saitek::DirectOutput>	library;
 
+		class SaitekX52;						// IMfdDevice backend
+
 		struct HandleInUse {
 			void*				handle;
 			std::atomic_bool	connectionAlive = true;
@@ -57,8 +60,11 @@ namespace DOHelper
 	public:
 		const wchar_t* const			PluginName;
 
+		/// Stamps input messages and times waiting for them - for every device used.
+		const IClock&					Clock;
+
 
-		explicit DirectOutputInstance(const wchar_t* pluginName);
+		explicit DirectOutputInstance(const wchar_t* pluginName, const IClock& = SystemClock::Instance());
 		DirectOutputInstance(const DirectOutputInstance&) = delete;
 		~DirectOutputInstance();
 
@@ -68,7 +74,7 @@ namespace DOHelper
 		std::vector<SaiDevice>			EnumerateFreeDevices()	const;
 		std::shared_future<SaiDevice>	WaitForNewDevice() 		const;
 
-		X52Output UseX52(const SaiDevice&);
+		X52Output UseX52(const SaiDevice&, OutputMode = OutputMode::Direct);
 
 	private:
 		auto FindConnection(void* handle);
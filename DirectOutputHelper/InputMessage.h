@@ -18,11 +18,19 @@ namespace DOHelper
 
 
 
+	/// Bits of ButtonPress data - same values as Saitek's SoftButton_* constants.
+	constexpr uint32_t SoftButtonSelect = 0x00000001;		// scroll click
+	constexpr uint32_t SoftButtonUp		= 0x00000002;
+	constexpr uint32_t SoftButtonDown	= 0x00000004;
+
+
+
 	/// An asynchron input event received from Saitek DirectOutput
 	struct InputMessage {
 		TimePoint 		time;
 		MessageKind 	kind;
 		uint32_t		optData = 0;
+		uint32_t		id		= 0;		// tagged by InputQueue, for latency tracing
 	};
 
 
@@ -1,45 +1,29 @@
 #include "InputQueue.h"
 
-#include "DirectOutputInstance.h"
+#include "MfdDevice.h"
+#include "Clock.h"
 #include "Utils/Debug.h"
-#include "Saitek/DirectOutputImpl.h"
 
 
 
 namespace DOHelper
 {
 
-	// helps hiding Windows.h inclusion just for DWORD...
-	struct InputQueue::CallbackConverter {
-		static void __stdcall OnPageChange(void* dev, DWORD dwPageId, bool activated, void* pCtxt)
-		{
-			uint32_t pageId = dwPageId;
-			InputQueue::OnPageChange(dev, pageId, activated, pCtxt);
-		}
-
-		static void __stdcall OnButtonPress(void* dev, DWORD dwButtonId, void* pCtxt)
-		{
-			uint32_t buttonId = dwButtonId;
-			InputQueue::OnButtonPress(dev, buttonId, pCtxt);
-		}
-	};
-
-
-
-	InputQueue::InputQueue(DirectOutputInstance& source, void* device) :
-		Source       { source },
-		DeviceHandle { device }
+	InputQueue::InputQueue(IMfdDevice& device) :
+		Device       { device },
+		DeviceHandle { device.Handle() }
 	{
-		Source.library->RegisterPageCallback	  (device, &CallbackConverter::OnPageChange,  this);
-		Source.library->RegisterSoftButtonCallback(device, &CallbackConverter::OnButtonPress, this);
+		for (size_t i = 0; i < Capacity; i++)
+			slots[i].sequence.store(i, std::memory_order_relaxed);
+
+		Device.RegisterInputHandlers(&OnPageChange, &OnButtonPress, this);
 	}
 
 
 	InputQueue::~InputQueue()
 	{
 		// Unregister
-		Source.library->RegisterPageCallback(DeviceHandle, nullptr, nullptr);
-		Source.library->RegisterSoftButtonCallback(DeviceHandle, nullptr, nullptr);
+		Device.RegisterInputHandlers(nullptr, nullptr, nullptr);
 	}
 
 
@@ -63,38 +47,128 @@ namespace DOHelper
 	}
 
 
+
+#pragma region Producers
+
 	void InputQueue::Push(MessageKind kind, uint32_t data)
 	{
+		const uint32_t id = lastId.fetch_add(1, std::memory_order_relaxed) + 1;
+
+		size_t pos = tail.load(std::memory_order_relaxed);
+		while (true)
 		{
-			std::unique_lock lock { mutex };
+			Slot&		 slot = slots[pos & (Capacity - 1)];
+			const size_t seq  = slot.sequence.load(std::memory_order_acquire);
+			const auto	 lead = static_cast<std::ptrdiff_t>(seq - pos);
+
+			if (lead == 0)
+			{
+				if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				{
+					// NOTE: DirectOutput provides no order for events but has own threads.
+					//		 Stamping after the claim keeps order close, Front enforces monotony.
+					slot.message = { Device.Clock().Now(), kind, data, id };
+					slot.sequence.store(pos + 1, std::memory_order_release);
+					break;
+				}
+			}
+			else if (lead < 0)
+			{
+				// consumer lags a full round behind
+				dropped.fetch_add(1, std::memory_order_relaxed);
+				return;
+			}
+			else
+			{
+				pos = tail.load(std::memory_order_relaxed);
+			}
+		}
+		WakeConsumer();
+	}
 
-			// NOTE: time should be set here to ensure monotony inside the queue
-			//		 DirectOutput provides no order for events but has own threads.
-			TimePoint stamp = TimePoint::clock::now();
-			messages.push_back({ stamp, kind, data });
+
+	// Pairs with the fence in Await: either the consumer sees the message or we see it sleeping.
+	void InputQueue::WakeConsumer()
+	{
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (!sleeping.load(std::memory_order_relaxed))
+			return;
+
+		// consumer holds the mutex until it waits
+		{
+			std::unique_lock lock { sleepMutex };
 		}
-		cond.notify_one();
+		wakeCond.notify_one();
 	}
 
+#pragma endregion
 
-	const InputMessage* InputQueue::PeekNext() const
+
+
+#pragma region Consumer
+
+	InputMessage* InputQueue::Front() const
 	{
-		std::unique_lock lock { mutex };
+		Slot& slot = slots[head & (Capacity - 1)];
+		if (slot.sequence.load(std::memory_order_acquire) != head + 1)
+			return nullptr;
+
+		if (slot.message.time < lastTime)
+			slot.message.time = lastTime;
 
-		return messages.empty() ? nullptr : &messages.front();
+		return &slot.message;
 	}
 
 
-	const InputMessage* InputQueue::PeekNext(const TimePoint& waitEnd) const
+	void InputQueue::Pop()
+	{
+		Slot& slot = slots[head & (Capacity - 1)];
+		lastTime = slot.message.time;
+		if (trace.has_value())
+			trace->push_back(slot.message);
+
+		slot.sequence.store(head + Capacity, std::memory_order_release);
+		++head;
+
+		const unsigned lost = DroppedCount();
+		if (lost != droppedReported)
+		{
+			Debug::Warning("InputQueue", "Input messages dropped on overflow:", lost);
+			droppedReported = lost;
+		}
+	}
+
+
+	const InputMessage* InputQueue::Await(const TimePoint& waitEnd) const
+	{
+		if (const InputMessage* msg = Front())
+			return msg;
+
+		std::unique_lock lock { sleepMutex };
+		sleeping.store(true, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+
+		// notified without a message (spurious wakeup): keep waiting till the deadline
+		while (Front() == nullptr && Device.Clock().WaitUntil(wakeCond, lock, waitEnd) == std::cv_status::no_timeout);
+
+		sleeping.store(false, std::memory_order_relaxed);
+		return Front();
+	}
+
+
+	const InputMessage* InputQueue::PeekNext() const
 	{
-		std::unique_lock lock { mutex };
+		return Front();
+	}
+
 
-		if (messages.empty())
-			cond.wait_until(lock, waitEnd);
+	const InputMessage* InputQueue::PeekNext(const TimePoint& waitEnd) const
+	{
+		const InputMessage* msg = Await(waitEnd);
 
-		return (messages.empty() || waitEnd < messages.front().time)
+		return (msg == nullptr || waitEnd < msg->time)
 			? nullptr 
-			: &messages.front();
+			: msg;
 	}
 
 
@@ -102,27 +176,24 @@ namespace DOHelper
 	{
 		optional<InputMessage> res;
 
-		std::unique_lock lock { mutex };
-		if (messages.empty())
-			cond.wait_until(lock, waitEnd);
-
-		if (messages.empty() || waitEnd < messages.front().time)
+		const InputMessage* msg = Await(waitEnd);
+		if (msg == nullptr || waitEnd < msg->time)
 			return res;
 
-		res = messages.front();
-		messages.pop_front();
+		res = *msg;
+		Pop();
 		return res;
 	}
 
 
 	InputMessage InputQueue::PopNext()
 	{
-		std::unique_lock lock { mutex };
+		const InputMessage* msg = Front();
 
-		LOGIC_ASSERT_M (!messages.empty(), "Use when consumer side is sure (Peeked) in the next message!");
+		LOGIC_ASSERT_M (msg != nullptr, "Use when consumer side is sure (Peeked) in the next message!");
 		
-		auto res = messages.front();
-		messages.pop_front();
+		auto res = *msg;
+		Pop();
 
 		return res;
 	}
@@ -130,9 +201,27 @@ namespace DOHelper
 
 	void InputQueue::Clear()
 	{
-		std::unique_lock lock { mutex };
-		messages.clear();
+		while (Front() != nullptr)
+			Pop();
+	}
+
+
+	void InputQueue::StartTrace()
+	{
+		trace.emplace();
 	}
 
 
+	std::vector<InputMessage> InputQueue::StopTrace()
+	{
+		LOGIC_ASSERT_M (trace.has_value(), "No trace started.");
+
+		std::vector<InputMessage> res = std::move(*trace);
+		trace.reset();
+		return res;
+	}
+
+#pragma endregion
+
+
 }	// namespace DOHelper
@@ -1,9 +1,12 @@
 #pragma once
 
 #include "InputMessage.h"
+#include <array>
+#include <atomic>
+#include <condition_variable>
 #include <mutex>
-#include <deque>
 #include <optional>
+#include <vector>
 
 
 
@@ -11,21 +14,51 @@ namespace DOHelper
 {
 
 	/// Synchronized buffer for input events of 1 device, to be processed by the thread handling outputs.
+	/// @remarks
+	///	  Lock- and allocation-free ring: any number of device threads push, a single thread consumes.
+	///	  When full, new messages are dropped and counted. The consumer sleeps on a condition
+	///	  variable (via the device's IClock), which producers only touch while it actually sleeps.
+	///	  A peeked message stays valid until popped.
 	class InputQueue {
 	public:
-		DirectOutputInstance&				Source;
+		static constexpr size_t Capacity = 256;
+		static_assert ((Capacity & (Capacity - 1)) == 0, "Capacity should be a power of 2.");
+
+		IMfdDevice&							Device;
 		void* const		 					DeviceHandle;
 
 	private:
-		mutable std::mutex					mutex;
-		mutable std::condition_variable 	cond;
-		std::deque<InputMessage>			messages;
+		// Sequence tells whose turn it is: == position: free for producer, == position + 1: readable.
+		struct Slot {
+			std::atomic<size_t>				sequence;
+			InputMessage					message;
+		};
+		mutable std::array<Slot, Capacity>	slots;
+
+		alignas(64) std::atomic<size_t>		tail = 0;				// claimed by producers
+		alignas(64) mutable size_t			head = 0;				// consumer only
+		mutable TimePoint					lastTime;				// to keep stamps monotonous
+		mutable unsigned					droppedReported = 0;
+		std::atomic<unsigned>				dropped = 0;
+		std::atomic<uint32_t>				lastId	= 0;
+
+		optional<std::vector<InputMessage>>	trace;					// consumer only
+
+		// to sleep only
+		mutable std::mutex					sleepMutex;
+		mutable std::condition_variable 	wakeCond;
+		mutable std::atomic_bool			sleeping = false;
 
 
 		static void OnPageChange (void* device, uint32_t pageId, bool activated, void* pCtxt);
 		static void OnButtonPress(void* device, uint32_t buttonId,				 void* pCtxt);
 
 		void Push(MessageKind kind, uint32_t data);
+		void WakeConsumer();
+
+		InputMessage*				Front()								const;
+		const InputMessage*			Await(const TimePoint& waitEnd)		const;
+		void						Pop();
 
 	public:
 		const InputMessage* 		PeekNext()							const;
@@ -34,12 +67,18 @@ namespace DOHelper
 		InputMessage				PopNext();
 		void						Clear();
 
-		InputQueue(DirectOutputInstance& source, void* deviceHandle);
-		~InputQueue();
+		/// Messages lost due to a full queue.
+		unsigned					DroppedCount()						const	{ return dropped.load(std::memory_order_relaxed); }
 
-		InputQueue(InputQueue&&) = delete;		// pinned address for DirectOutput callbacks
+		/// Record every message consumed from now on - raw, as received from the device.
+		/// @remarks	Consumer side only, like popping.
+		void						StartTrace();
+		std::vector<InputMessage>	StopTrace();
+
+		explicit InputQueue(IMfdDevice&);
+		~InputQueue();
 
-		struct CallbackConverter;				// internal
+		InputQueue(InputQueue&&) = delete;		// pinned address for device callbacks
 	};
 
 
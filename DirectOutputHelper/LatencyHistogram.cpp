@@ -0,0 +1,54 @@
+#include "LatencyHistogram.h"
+
+#include "Utils/Debug.h"
+#include <algorithm>
+#include <cmath>
+
+
+
+namespace DOHelper
+{
+
+	void LatencyHistogram::Add(Duration d)
+	{
+		d = std::max(d, Duration::zero());
+
+		const size_t i = std::min(static_cast<size_t>(d / BucketWidth), BucketCount - 1);
+		++buckets[i];
+		++count;
+		total += d;
+		max	   = std::max(max, d);
+	}
+
+
+	void LatencyHistogram::Clear()
+	{
+		*this = {};
+	}
+
+
+	Duration LatencyHistogram::Mean() const
+	{
+		return count == 0 ? Duration::zero() : total / count;
+	}
+
+
+	Duration LatencyHistogram::Percentile(double p) const
+	{
+		LOGIC_ASSERT (0.0 <= p && p <= 1.0);
+		if (count == 0)
+			return Duration::zero();
+
+		const auto rank	= static_cast<unsigned>(std::ceil(p * count));
+		unsigned   seen	= 0;
+		for (size_t i = 0; i < BucketCount - 1; i++)
+		{
+			seen += buckets[i];
+			if (rank <= seen)
+				return (i + 1) * BucketWidth;
+		}
+		return max;
+	}
+
+
+}	// namespace DOHelper
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "DOHelperTypes.h"
+#include <array>
+
+
+
+namespace DOHelper
+{
+	using namespace std::chrono_literals;
+
+
+	/// Distribution of durations in fixed-width buckets - allocation-free, for measuring on the fly.
+	class LatencyHistogram {
+	public:
+		static constexpr Duration	BucketWidth = 5ms;
+		static constexpr size_t		BucketCount = 200;		// the last one collects anything longer
+
+	private:
+		std::array<unsigned, BucketCount>	buckets {};
+		unsigned							count = 0;
+		Duration							total = Duration::zero();
+		Duration							max	  = Duration::zero();
+
+	public:
+		void		Add(Duration);
+		void		Clear();
+
+		unsigned	Count()		const	{ return count; }
+		Duration	Max()		const	{ return max; }
+		Duration	Mean()		const;
+
+		/// Upper bound of the bucket reached by fraction @p p (0..1) of the samples.
+		Duration	Percentile(double p) const;
+	};
+
+
+}	// namespace DOHelper
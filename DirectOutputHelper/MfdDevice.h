@@ -0,0 +1,46 @@
+#pragma once
+
+#include "DOHelperTypes.h"
+
+
+
+namespace DOHelper
+{
+
+	/// Same value as Saitek's E_PAGENOTACTIVE - DirectOutput.h is only included by DirectOutputInstance.
+	constexpr HRESULT PageNotActive = static_cast<HRESULT>(0xFF040001);
+
+
+
+	/// Backend of an X52Output: the per-device part of the DirectOutput API.
+	/// @remarks
+	///	  Commands return HRESULTs just as DirectOutput does - including PageNotActive.
+	///	  Input handlers may be invoked from any thread, X52Output's InputQueue synchronizes them.
+	class IMfdDevice {
+	public:
+		using PageHandler	= void (*)(void* device, uint32_t pageId, bool activated, void* context);
+		using ButtonHandler	= void (*)(void* device, uint32_t buttons, void* context);
+
+		virtual void*			Handle()		const noexcept = 0;
+		virtual const IClock&	Clock()			const noexcept = 0;
+
+		/// If false, the device went stale permanently.
+		virtual bool			IsConnected()	const noexcept = 0;
+
+		virtual HRESULT	AddPage(uint32_t pageId, bool setActive)							= 0;
+		virtual HRESULT	RemovePage(uint32_t pageId)											= 0;
+		virtual HRESULT	SetLed(uint32_t pageId, uint32_t ledId, bool on)					= 0;
+		virtual HRESULT	SetString(uint32_t pageId, uint32_t line, uint32_t length, const wchar_t*) = 0;
+
+		/// Wait for the commands issued so far to be executed - for backends deferring them.
+		/// @returns	result of the last one executed
+		virtual HRESULT	Flush()																{ return S_OK; }
+
+		/// nullptrs unregister.
+		virtual void	RegisterInputHandlers(PageHandler, ButtonHandler, void* context)	= 0;
+
+		virtual ~IMfdDevice() = default;
+	};
+
+
+}	// namespace DOHelper
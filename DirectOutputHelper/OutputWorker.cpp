@@ -0,0 +1,236 @@
+#include "OutputWorker.h"
+
+#include "Utils/BasicUtils.h"
+#include "Utils/Debug.h"
+#include <algorithm>
+#include <utility>
+
+
+
+namespace DOHelper
+{
+
+	OutputWorker::OutputWorker(std::unique_ptr<IMfdDevice> target) :
+		device { std::move(target) },
+		thread { &OutputWorker::Run, this }
+	{
+		LOGIC_ASSERT (device != nullptr);
+	}
+
+
+	OutputWorker::~OutputWorker()
+	{
+		{
+			std::unique_lock lock { mutex };
+			stopping = true;
+		}
+		wake.notify_one();
+		progress.notify_all();
+		thread.join();
+	}
+
+
+	auto OutputWorker::GetStats() const -> Stats
+	{
+		std::unique_lock lock { mutex };
+		return stats;
+	}
+
+
+
+#pragma region Worker Thread
+
+	bool OutputWorker::Command::Overrides(const Command& pending) const
+	{
+		return kind == pending.kind
+			&& pageId == pending.pageId
+			&& target == pending.target
+			&& (kind == SetLed || kind == SetString);
+	}
+
+
+	HRESULT OutputWorker::Execute(const Command& cmd)
+	{
+		switch (cmd.kind)
+		{
+			case Command::AddPage:
+				return device->AddPage(cmd.pageId, cmd.flag);
+			case Command::RemovePage:
+				return device->RemovePage(cmd.pageId);
+			case Command::SetLed:
+				return device->SetLed(cmd.pageId, cmd.target, cmd.flag);
+			case Command::SetString:
+				return device->SetString(cmd.pageId, cmd.target, static_cast<uint32_t>(cmd.text.length()), cmd.text.data());
+		}
+		LOGIC_ASSERT_M (false, "Unknown command.");
+		return E_UNEXPECTED;
+	}
+
+
+	// Drains the queue even when stopping.
+	void OutputWorker::Run()
+	{
+		std::unique_lock lock { mutex };
+		while (true)
+		{
+			wake.wait(lock, [this] { return stopping || !commands.empty(); });
+			if (commands.empty())
+				return;
+
+			const Command cmd = std::move(commands.front());
+			commands.pop_front();
+			busy = true;
+
+			lock.unlock();
+			progress.notify_all();
+			const HRESULT hr = Execute(cmd);
+			lock.lock();
+
+			busy	   = false;
+			lastResult = hr;
+			++stats.executed;
+
+			if (SUCCEEDED(hr))
+			{
+				if (cmd.kind != Command::AddPage || cmd.flag)
+					Utils::EraseAllEqual(inactivePages, cmd.pageId);
+			}
+			else if (hr == PageNotActive)
+			{
+				if (!Utils::Contains(inactivePages, cmd.pageId))
+					inactivePages.push_back(cmd.pageId);
+			}
+			else if (!failure.has_value())
+			{
+				Debug::Warning("OutputWorker", "Command failed:", cmd.kind);
+				failure = hr;
+			}
+			progress.notify_all();
+		}
+	}
+
+#pragma endregion
+
+
+
+#pragma region Caller Side
+
+	HRESULT OutputWorker::Push(Command&& cmd)
+	{
+		std::unique_lock lock { mutex };
+		if (failure.has_value())
+			return *std::exchange(failure, Nothing);
+
+		if (cmd.kind == Command::SetLed || cmd.kind == Command::SetString)
+		{
+			if (Utils::Contains(inactivePages, cmd.pageId))
+				return PageNotActive;
+
+			// last writer wins - unless the page is added or removed in between
+			for (auto it = commands.rbegin(); it != commands.rend() && !it->IsBarrierFor(cmd.pageId); ++it)
+			{
+				if (cmd.Overrides(*it))
+				{
+					*it = std::move(cmd);
+					++stats.merged;
+					return S_OK;
+				}
+			}
+		}
+
+		if (commands.size() >= Capacity)
+			Debug::Warning("OutputWorker", "Command queue full, waiting for device.");
+
+		progress.wait(lock, [this] { return commands.size() < Capacity; });
+		commands.push_back(std::move(cmd));
+		stats.maxDepth = std::max(stats.maxDepth, commands.size());
+
+		lock.unlock();
+		wake.notify_one();
+		return S_OK;
+	}
+
+
+	HRESULT OutputWorker::AddPage(uint32_t pageId, bool setActive)
+	{
+		return Push({ Command::AddPage, pageId, 0, setActive });
+	}
+
+
+	HRESULT OutputWorker::RemovePage(uint32_t pageId)
+	{
+		return Push({ Command::RemovePage, pageId });
+	}
+
+
+	HRESULT OutputWorker::SetLed(uint32_t pageId, uint32_t ledId, bool on)
+	{
+		return Push({ Command::SetLed, pageId, ledId, on });
+	}
+
+
+	HRESULT OutputWorker::SetString(uint32_t pageId, uint32_t line, uint32_t length, const wchar_t* text)
+	{
+		return Push({ Command::SetString, pageId, line, false, std::wstring(text, length) });
+	}
+
+
+	/// Forgets pages reported inactive: the result tells the actual state.
+	HRESULT OutputWorker::Flush()
+	{
+		std::unique_lock lock { mutex };
+		progress.wait(lock, [this] { return commands.empty() && !busy; });
+
+		inactivePages.clear();
+		if (failure.has_value())
+		{
+			lastResult = S_OK;
+			return *std::exchange(failure, Nothing);
+		}
+
+		return std::exchange(lastResult, S_OK);
+	}
+
+
+	// An activated page accepts commands again.
+	void OutputWorker::OnPageChange(void* dev, uint32_t pageId, bool activated, void* pCtxt)
+	{
+		auto& self = *static_cast<OutputWorker*>(pCtxt);
+		if (activated)
+		{
+			std::unique_lock lock { self.mutex };
+			Utils::EraseAllEqual(self.inactivePages, pageId);
+		}
+		self.pageHandler(dev, pageId, activated, self.handlerContext);
+	}
+
+
+	void OutputWorker::OnButtonPress(void* dev, uint32_t buttons, void* pCtxt)
+	{
+		auto& self = *static_cast<OutputWorker*>(pCtxt);
+		self.buttonHandler(dev, buttons, self.handlerContext);
+	}
+
+
+	// Handlers set before registering, cleared only after unregistering.
+	void OutputWorker::RegisterInputHandlers(PageHandler onPage, ButtonHandler onButtons, void* context)
+	{
+		if (onPage == nullptr && onButtons == nullptr)
+			device->RegisterInputHandlers(nullptr, nullptr, nullptr);
+
+		pageHandler	   = onPage;
+		buttonHandler  = onButtons;
+		handlerContext = context;
+
+		if (onPage != nullptr || onButtons != nullptr)
+		{
+			device->RegisterInputHandlers(onPage	!= nullptr ? &OnPageChange  : nullptr,
+										  onButtons != nullptr ? &OnButtonPress : nullptr,
+										  this												);
+		}
+	}
+
+#pragma endregion
+
+
+}	// namespace DOHelper
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "MfdDevice.h"
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+
+namespace DOHelper
+{
+
+	/// Runs the commands of an IMfdDevice on its own thread, so the caller never waits for the driver.
+	/// @remarks
+	///	  Commands are executed in order. A line or LED command still pending is overwritten
+	///	  in place by a newer one to the same target, so a slow driver gets only the latest state.
+	///	  Results arrive late: a page reported inactive makes further line and LED commands to
+	///	  that page fail immediately with PageNotActive (until it's activated again) - this is
+	///	  what X52Output's recovery needs. Any other failure is reported once, by the next
+	///	  command (which is then dropped) or Flush.
+	///	  Use Flush for an up-to-date result, e.g. when probing.
+	class OutputWorker final : public IMfdDevice {
+	public:
+		/// The caller waits only if this many commands are pending.
+		static constexpr size_t Capacity = 64;
+
+		struct Stats {
+			unsigned	executed = 0;
+			unsigned	merged	 = 0;		// overwritten while pending
+			size_t		maxDepth = 0;
+		};
+
+	private:
+		struct Command {
+			enum Kind { AddPage, RemovePage, SetLed, SetString } kind;
+			uint32_t		pageId;
+			uint32_t		target;			// line or LED id
+			bool			flag;			// LED on / set as active
+			std::wstring	text;
+
+			bool IsBarrierFor(uint32_t page)	const	{ return pageId == page && (kind == AddPage || kind == RemovePage); }
+			bool Overrides(const Command&)		const;
+		};
+
+		const std::unique_ptr<IMfdDevice>	device;
+
+		mutable std::mutex				mutex;
+		std::condition_variable			wake;
+		mutable std::condition_variable	progress;
+		std::deque<Command>				commands;
+		bool							busy	 = false;
+		bool							stopping = false;
+
+		std::vector<uint32_t>			inactivePages;		// as reported by executed commands
+		optional<HRESULT>				failure;			// not reported yet
+		HRESULT							lastResult = S_OK;
+		Stats							stats;
+
+		PageHandler						pageHandler	   = nullptr;
+		ButtonHandler					buttonHandler  = nullptr;
+		void*							handlerContext = nullptr;
+
+		std::thread						thread;
+
+
+		static void OnPageChange (void* device, uint32_t pageId, bool activated, void* pCtxt);
+		static void OnButtonPress(void* device, uint32_t buttons,				 void* pCtxt);
+
+		HRESULT	Push(Command&&);
+		HRESULT	Execute(const Command&);
+		void	Run();
+
+	public:
+		explicit OutputWorker(std::unique_ptr<IMfdDevice>);
+		OutputWorker(const OutputWorker&) = delete;
+
+		/// Executes pending commands before returning.
+		~OutputWorker() override;
+
+		IMfdDevice&		Target()		const	{ return *device; }
+		Stats			GetStats()		const;
+
+
+		// ---- IMfdDevice -----------------------
+
+		void*			Handle()		const noexcept override		{ return device->Handle(); }
+		const IClock&	Clock()			const noexcept override		{ return device->Clock(); }
+		bool			IsConnected()	const noexcept override		{ return device->IsConnected(); }
+
+		HRESULT	AddPage(uint32_t pageId, bool setActive)								override;
+		HRESULT	RemovePage(uint32_t pageId)												override;
+		HRESULT	SetLed(uint32_t pageId, uint32_t ledId, bool on)						override;
+		HRESULT	SetString(uint32_t pageId, uint32_t line, uint32_t length, const wchar_t*)	override;
+		HRESULT	Flush()																	override;
+		void	RegisterInputHandlers(PageHandler, ButtonHandler, void* context)		override;
+	};
+
+
+}	// namespace DOHelper
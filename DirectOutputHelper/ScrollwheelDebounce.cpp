@@ -17,7 +17,7 @@ namespace DOHelper
 		if ((presses & bitmask) == 0)
 			return;
 
-		bool newPress = last + PressCancelDelay <= at;
+		bool newPress = last + cancelDelay <= at;
 		last = at;
 		emittable |= newPress;
 	}
@@ -41,17 +41,17 @@ namespace DOHelper
 	bool ScrollwheelDebounce::ScrollTracker::IsEmittableAt(TimePoint at) const
 	{
 		return emitPend	&&
-			(  balance != 0 && last + OppositePressDelay <= at
+			(  balance != 0 && last + oppositeDelay <= at
 			|| balance < -2	|| 2 < balance
-			|| first + OppositeDelayLimit <= at				  );
+			|| first + delayLimit <= at					 );
 	}
 
 
 	bool ScrollwheelDebounce::ScrollTracker::IsCancellingAt(TimePoint at) const
 	{
 		return !emitPend 
-			&& at < last + OppositePressDelay
-			&& at < first + OppositeDelayLimit;
+			&& at < last + oppositeDelay
+			&& at < first + delayLimit;
 	}
 
 
@@ -64,8 +64,8 @@ namespace DOHelper
 
 		DBG_ASSERT_M (!IsEmittableAt(at), "Missed Emit!");
 
-		const bool inDelayWindow = at < last  + OppositePressDelay;
-		const bool inDelayLimit  = at < first + OppositeDelayLimit;
+		const bool inDelayWindow = at < last  + oppositeDelay;
+		const bool inDelayLimit  = at < first + delayLimit;
 		const bool newPress		 = !inDelayWindow || !inDelayLimit;
 		
 		last = at;
@@ -99,9 +99,10 @@ namespace DOHelper
 #pragma region Combine Presses
 
 
-	ScrollwheelDebounce::ScrollwheelDebounce(uint32_t upMask, uint32_t downMask, uint32_t pressMask) :
-		press		 { pressMask },
-		scroll		 { upMask, downMask },
+	ScrollwheelDebounce::ScrollwheelDebounce(uint32_t upMask, uint32_t downMask, uint32_t pressMask, const DebounceTiming& timing) :
+		Timing		 { timing },
+		press		 { pressMask, timing.pressCancelDelay },
+		scroll		 { upMask, downMask, timing.oppositePressDelay, timing.oppositeDelayLimit },
 		relevantMask { upMask | downMask | pressMask }
 	{
 	}
@@ -177,7 +178,7 @@ namespace DOHelper
 
 			press.Receive(msg->optData, t);
 
-			if (lastScrollWasPressed && t < scroll.last + ScrollPressCancel)
+			if (lastScrollWasPressed && t < scroll.last + Timing.scrollPressCancel)
 				continue;
 
 			// but a single press won't be delayed to wait for a potential Press & Scroll
@@ -222,7 +223,7 @@ namespace DOHelper
 	{
 		DBG_ASSERT (scroll.emitPend);
 
-		const TimePoint delayMax = scroll.first + OppositeDelayLimit;
+		const TimePoint delayMax = scroll.first + Timing.oppositeDelayLimit;
 
 		// End of continuous bouncy sequence, trigger emit
 		auto isBoundary = [this](const InputMessage& n)
@@ -234,11 +235,11 @@ namespace DOHelper
 		bool emittable = false;
 		while (!emittable)
 		{
-			TimePoint windowEnd = scroll.last + OppositePressDelay;
+			TimePoint windowEnd = scroll.last + Timing.oppositePressDelay;
 
 			DBG_ASSERT (scroll.IsEmittableAt(windowEnd) && scroll.IsEmittableAt(delayMax));
 
-			// NOTE: If next is within OppositePressDelay but over OppositeDelayLimit
+			// NOTE: If next is within oppositePressDelay but over oppositeDelayLimit
 			//		 [or balance > 2], it will init the Balance of a new scroll input.
 			const InputMessage* next = queue.PeekNext(std::min(windowEnd, delayMax));
 			
@@ -13,14 +13,22 @@ namespace DOHelper
 
 
 
+	/// Windows of ScrollwheelDebounce - see DebounceReplay to evaluate alternatives.
+	struct DebounceTiming {
+		Duration pressCancelDelay	= 40ms;		// repeated press within: bounce
+		Duration oppositePressDelay	= 40ms;		// scroll bounces are awaited this long after each other
+		Duration oppositeDelayLimit	= 120ms;	// ... but at most this long after the first
+		Duration scrollPressCancel	= 400ms;	// presses ignored after a Press & Scroll
+	};
+
+
+
 	/// A consumer-side filter to get cleaner inputs from X52's scrolling wheel.
 	class ScrollwheelDebounce {
+	public:
+		const DebounceTiming	Timing;
 
-		static constexpr Duration PressCancelDelay	 = 40ms;
-		static constexpr Duration OppositePressDelay = 40ms;
-		static constexpr Duration OppositeDelayLimit = 120ms;
-		static constexpr Duration ScrollPressCancel  = 400ms;
-
+	private:
 
 		// Outside last: start timer + send Event
 		// Next within timer: just ignore (no long press yet)
@@ -29,6 +37,7 @@ namespace DOHelper
 		//    `press1       `emit          `timeout
 		struct PressTracker {
 			const uint32_t	bitmask;
+			const Duration	cancelDelay;
 			TimePoint		last;
 			bool			emittable = false;
 			
@@ -44,6 +53,8 @@ namespace DOHelper
 		struct ScrollTracker {
 			const uint32_t	upMask;
 			const uint32_t	downMask;
+			const Duration	oppositeDelay;
+			const Duration	delayLimit;
 			TimePoint		first;
 			TimePoint		last;
 			bool			emitPend = false;
@@ -74,7 +85,7 @@ namespace DOHelper
 		bool		ProcessBounce(const InputMessage&);
 
 	public:
-		ScrollwheelDebounce(uint32_t upMask, uint32_t downMask, uint32_t pressMask);
+		ScrollwheelDebounce(uint32_t upMask, uint32_t downMask, uint32_t pressMask, const DebounceTiming& = {});
 
 		optional<InputMessage> Receive(InputQueue&, TimePoint until);
 	};
@@ -0,0 +1,355 @@
+#include "VirtualX52.h"
+
+#include "Utils/BasicUtils.h"
+#include "Utils/Debug.h"
+#include <algorithm>
+#include <utility>
+
+
+
+namespace DOHelper
+{
+
+	VirtualX52::VirtualX52(const IClock& clock) :
+		clock		{ clock },
+		inputThread	{ &VirtualX52::RunInputThread, this }
+	{
+	}
+
+
+	VirtualX52::~VirtualX52()
+	{
+		{
+			std::unique_lock lock { inputMutex };
+			stopping = true;
+		}
+		inputCond.notify_one();
+		inputThread.join();
+	}
+
+
+
+#pragma region Simulated User
+
+	void VirtualX52::Post(Input input)
+	{
+		{
+			std::unique_lock lock { inputMutex };
+			inputs.push_back(input);
+		}
+		inputCond.notify_one();
+	}
+
+
+	void VirtualX52::PostPageTurn(bool next)
+	{
+		Post({ Input::PageTurn, next });
+	}
+
+
+	void VirtualX52::PostButtons(uint32_t buttons)
+	{
+		Post({ Input::Buttons, buttons });
+	}
+
+
+	void VirtualX52::Disconnect()
+	{
+		std::unique_lock lock { stateMutex };
+
+		connected = false;
+		pages.clear();
+		activePage.reset();
+	}
+
+
+	void VirtualX52::FailNextCommand(HRESULT hr)
+	{
+		std::unique_lock lock { stateMutex };
+
+		fault = hr;
+	}
+
+
+	// Like DirectOutput, handlers are invoked on a thread of the device.
+	void VirtualX52::RunInputThread()
+	{
+		std::unique_lock lock { inputMutex };
+		while (true)
+		{
+			inputCond.wait(lock, [this] { return stopping || !inputs.empty(); });
+			if (stopping)
+				return;
+
+			const Input input = inputs.front();
+			inputs.pop_front();
+
+			// new inputs may wake us earlier
+			const TimePoint due = clock.Now() + InputDelay;
+			while (!stopping && clock.Now() < due)
+				clock.WaitUntil(inputCond, lock, due);
+			if (stopping)
+				return;
+
+			lock.unlock();
+			Deliver(input);
+			lock.lock();
+		}
+	}
+
+
+	void VirtualX52::Deliver(const Input& input)
+	{
+		optional<uint32_t> left;
+		optional<uint32_t> entered;
+		{
+			std::unique_lock lock { stateMutex };
+			if (!connected)
+				return;
+
+			switch (input.kind)
+			{
+				case Input::PageDeactivated:
+					left = input.data;
+					break;
+
+				case Input::Buttons:
+				{
+					// only our pages receive soft buttons
+					if (!activePage.has_value())
+						return;
+
+					lock.unlock();
+					std::unique_lock guard { handlerMutex };
+					if (buttonHandler != nullptr)
+						buttonHandler(Handle(), input.data, handlerContext);
+					return;
+				}
+
+				case Input::PageTurn:
+				{
+					// positions: added pages, then the profile's own page
+					const size_t count = pages.size();
+					const size_t pos   = activePage.has_value()
+						? Utils::FindIf(pages, [this](const PageState& p) { return p.id == *activePage; }) - pages.begin()
+						: count;
+					const size_t to	   = input.data ? (pos + 1) % (count + 1)
+													: (pos + count) % (count + 1);
+					left = activePage;
+					if (to < count)
+						activePage = pages[to].id;
+					else
+						activePage.reset();
+					entered = activePage;
+					break;
+				}
+			}
+		}
+
+		if (left.has_value())
+			NotifyPage(*left, false);
+		if (entered.has_value())
+			NotifyPage(*entered, true);
+	}
+
+
+	void VirtualX52::NotifyPage(uint32_t id, bool activated)
+	{
+		std::unique_lock guard { handlerMutex };
+
+		if (pageHandler != nullptr)
+			pageHandler(Handle(), id, activated, handlerContext);
+	}
+
+#pragma endregion
+
+
+
+#pragma region Inspection
+
+	optional<uint32_t> VirtualX52::ActivePage() const
+	{
+		std::unique_lock lock { stateMutex };
+		return activePage;
+	}
+
+
+	std::vector<uint32_t> VirtualX52::PageStack() const
+	{
+		std::unique_lock lock { stateMutex };
+
+		std::vector<uint32_t> ids;
+		ids.reserve(pages.size());
+		for (const PageState& p : pages)
+			ids.push_back(p.id);
+
+		return ids;
+	}
+
+
+	auto VirtualX52::GetPage(uint32_t id) const -> optional<PageState>
+	{
+		std::unique_lock lock { stateMutex };
+
+		auto it = Utils::FindIf(pages, [id](const PageState& p) { return p.id == id; });
+		if (it == pages.end())
+			return Nothing;
+
+		return *it;
+	}
+
+
+	std::wstring VirtualX52::DisplayedLine(size_t i) const
+	{
+		LOGIC_ASSERT (i < LineCount);
+
+		std::unique_lock lock { stateMutex };
+		if (!activePage.has_value())
+			return {};
+
+		auto it = Utils::FindIf(pages, [this](const PageState& p) { return p.id == *activePage; });
+		return it->lines[i];
+	}
+
+#pragma endregion
+
+
+
+#pragma region IMfdDevice
+
+	// Common part of every command.
+	void VirtualX52::Roundtrip()
+	{
+		if (CallLatency > Duration::zero())
+		{
+			// nobody notifies: just elapse on the clock
+			std::mutex				latencyMutex;
+			std::condition_variable	latencyCond;
+			std::unique_lock		lock { latencyMutex };
+
+			const TimePoint due = clock.Now() + CallLatency;
+			while (clock.WaitUntil(latencyCond, lock, due) == std::cv_status::no_timeout);
+		}
+		++callCount;
+	}
+
+
+	auto VirtualX52::FindPage(uint32_t id) -> PageState*
+	{
+		auto it = Utils::FindIf(pages, [id](const PageState& p) { return p.id == id; });
+		return it == pages.end() ? nullptr : &*it;
+	}
+
+
+	bool VirtualX52::IsConnected() const noexcept
+	{
+		std::unique_lock lock { stateMutex };
+		return connected;
+	}
+
+
+	HRESULT VirtualX52::AddPage(uint32_t pageId, bool setActive)
+	{
+		Roundtrip();
+
+		std::unique_lock lock { stateMutex };
+		if (!connected)
+			return E_HANDLE;
+		if (FAILED(fault))
+			return std::exchange(fault, S_OK);
+		if (FindPage(pageId) != nullptr)
+			return E_INVALIDARG;
+
+		pages.push_back({ pageId });
+		if (setActive)
+		{
+			// As DirectOutput: no Activated for the new page, but the old one gets Deactivated asynchronously.
+			if (activePage.has_value())
+				Post({ Input::PageDeactivated, *activePage });
+
+			activePage = pageId;
+		}
+		return S_OK;
+	}
+
+
+	// Removing the active page throws to the profile's page - without notification.
+	HRESULT VirtualX52::RemovePage(uint32_t pageId)
+	{
+		Roundtrip();
+
+		std::unique_lock lock { stateMutex };
+		if (!connected)
+			return E_HANDLE;
+		if (FAILED(fault))
+			return std::exchange(fault, S_OK);
+
+		auto it = Utils::FindIf(pages, [pageId](const PageState& p) { return p.id == pageId; });
+		if (it == pages.end())
+			return E_INVALIDARG;
+
+		if (activePage == pageId)
+			activePage.reset();
+
+		pages.erase(it);
+		return S_OK;
+	}
+
+
+	HRESULT VirtualX52::SetLed(uint32_t pageId, uint32_t ledId, bool on)
+	{
+		Roundtrip();
+
+		std::unique_lock lock { stateMutex };
+		if (!connected)
+			return E_HANDLE;
+		if (FAILED(fault))
+			return std::exchange(fault, S_OK);
+
+		PageState* page = FindPage(pageId);
+		if (page == nullptr || ledId >= 32)
+			return E_INVALIDARG;
+		if (activePage != pageId)
+			return PageNotActive;
+
+		const uint32_t bit = 1u << ledId;
+		page->leds = on ? (page->leds | bit) : (page->leds & ~bit);
+		return S_OK;
+	}
+
+
+	HRESULT VirtualX52::SetString(uint32_t pageId, uint32_t line, uint32_t length, const wchar_t* text)
+	{
+		Roundtrip();
+
+		std::unique_lock lock { stateMutex };
+		if (!connected)
+			return E_HANDLE;
+		if (FAILED(fault))
+			return std::exchange(fault, S_OK);
+
+		PageState* page = FindPage(pageId);
+		if (page == nullptr || line >= LineCount)
+			return E_INVALIDARG;
+		if (activePage != pageId)
+			return PageNotActive;
+
+		page->lines[line].assign(text, std::min<size_t>(length, LineLength));
+		return S_OK;
+	}
+
+
+	// Waits for handlers being invoked - they won't be called after returning.
+	void VirtualX52::RegisterInputHandlers(PageHandler onPage, ButtonHandler onButtons, void* context)
+	{
+		std::unique_lock guard { handlerMutex };
+
+		pageHandler	   = onPage;
+		buttonHandler  = onButtons;
+		handlerContext = context;
+	}
+
+#pragma endregion
+
+
+}	// namespace DOHelper
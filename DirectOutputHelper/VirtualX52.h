@@ -0,0 +1,126 @@
+#pragma once
+
+#include "MfdDevice.h"
+#include "Clock.h"
+#include <array>
+#include <atomic>
+#include <deque>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+
+namespace DOHelper
+{
+
+	/// In-memory X52 Pro MFD - for tests and benchmarks without driver or hardware.
+	/// @remarks
+	///	  Keeps what the real device would: the stack of added pages, each with its
+	///	  3 x 16 character text buffer and LED bits. Every command takes @a CallLatency,
+	///	  imitating the driver roundtrip. Delays elapse on the injected IClock, so a
+	///	  VirtualClock skips them.
+	///	  User actions are simulated by the Post* methods: like DirectOutput, the device
+	///	  invokes the input handlers from its own thread, @a InputDelay after posting.
+	///	  Paging cycles through the added pages and the profile's own page (none active).
+	class VirtualX52 final : public IMfdDevice {
+	public:
+		static constexpr size_t LineCount  = 3;
+		static constexpr size_t LineLength = 16;
+
+		struct PageState {
+			uint32_t								id;
+			std::array<std::wstring, LineCount>		lines;
+			uint32_t								leds = 0;		// bit per LED id
+		};
+
+		// Set these before use.
+
+		/// Per command.
+		Duration	CallLatency	= Duration::zero();
+		/// From posting a user action till its handlers are invoked.
+		Duration	InputDelay	= Duration::zero();
+
+	private:
+		struct Input {
+			enum Kind { PageTurn, Buttons, PageDeactivated } kind;
+			uint32_t	data;
+		};
+
+		const IClock&				clock;
+
+		mutable std::mutex			stateMutex;
+		std::vector<PageState>		pages;				// in order of adding
+		optional<uint32_t>			activePage;
+		bool						connected = true;
+		HRESULT						fault	  = S_OK;		// of the next command
+		std::atomic<unsigned>		callCount = 0;
+
+		std::mutex					handlerMutex;		// held while invoking
+		PageHandler					pageHandler	  = nullptr;
+		ButtonHandler				buttonHandler = nullptr;
+		void*						handlerContext = nullptr;
+
+		std::mutex					inputMutex;
+		std::condition_variable		inputCond;
+		std::deque<Input>			inputs;
+		bool						stopping = false;
+		std::thread					inputThread;
+
+
+		void		Roundtrip();
+		PageState*	FindPage(uint32_t id);
+		void		Post(Input);
+		void		RunInputThread();
+		void		Deliver(const Input&);
+		void		NotifyPage(uint32_t id, bool activated);
+
+	public:
+		explicit VirtualX52(const IClock& = SystemClock::Instance());
+		VirtualX52(const VirtualX52&) = delete;
+		~VirtualX52() override;
+
+
+		// ---- Simulated user -------------------
+
+		/// Scroll the page wheel to the next (or previous) page.
+		void PostPageTurn(bool next = true);
+
+		/// Soft buttons as DirectOutput's SoftButton_* bits.
+		void PostButtons(uint32_t buttons);
+
+		/// Unplug: any further command fails with E_HANDLE.
+		void Disconnect();
+
+		/// Glitch: the next command fails with @p hr, once.
+		void FailNextCommand(HRESULT hr);
+
+
+		// ---- Inspection -----------------------
+
+		optional<uint32_t>		ActivePage()				const;
+		std::vector<uint32_t>	PageStack()					const;
+		optional<PageState>		GetPage(uint32_t id)		const;
+
+		/// Displayed text: of the active page, empty if none.
+		std::wstring			DisplayedLine(size_t i)		const;
+
+		/// Commands received so far.
+		unsigned				CallCount()					const	{ return callCount; }
+
+
+		// ---- IMfdDevice -----------------------
+
+		void*			Handle()		const noexcept override		{ return const_cast<VirtualX52*>(this); }
+		const IClock&	Clock()			const noexcept override		{ return clock; }
+		bool			IsConnected()	const noexcept override;
+
+		HRESULT	AddPage(uint32_t pageId, bool setActive)								override;
+		HRESULT	RemovePage(uint32_t pageId)												override;
+		HRESULT	SetLed(uint32_t pageId, uint32_t ledId, bool on)						override;
+		HRESULT	SetString(uint32_t pageId, uint32_t line, uint32_t length, const wchar_t*)	override;
+		void	RegisterInputHandlers(PageHandler, ButtonHandler, void* context)		override;
+	};
+
+
+}	// namespace DOHelper
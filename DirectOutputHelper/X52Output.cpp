@@ -1,16 +1,18 @@
 ﻿#include "InputQueue.h"
 
-#include "DirectOutputInstance.h"
+#include "Clock.h"
 #include "DirectOutputError.h"
 #include "InputMessage.h"
+#include "MfdDevice.h"
 #include "X52Output.h"
 #include "X52Page.h"
 #include "Utils/BasicUtils.h"
 #include "Utils/CastUtils.h"
 
-#include "Saitek/DirectOutputImpl.h"
 #include <algorithm>
+#include <bitset>
 #include <shared_mutex>
+#include <thread>
 
 
 
@@ -28,9 +30,10 @@ namespace DOHelper
 	X52Output::X52Output(X52Output&&) noexcept = default;
 
 
-	X52Output::X52Output(void* handle, DirectOutputInstance& owner) :
-		inputQueue	  { new InputQueue { owner, handle } },
-		wheelDebounce { SoftButton_Up, SoftButton_Down, SoftButton_Select }
+	X52Output::X52Output(std::unique_ptr<IMfdDevice> device) :
+		backend		  { std::move(device) },
+		inputQueue	  { new InputQueue { *backend } },
+		wheelDebounce { SoftButtonUp, SoftButtonDown, SoftButtonSelect }
 	{
 	}
 
@@ -41,30 +44,23 @@ namespace DOHelper
 		{
 			// NOTE: A DirectOutput failure is probably not a pborlem here,
 			//		 as current Handle is going to be discarded.
-			for (Page* p : pages)
+			for (Page* p = firstPage; p != nullptr; p = p->nextAdded)
 				OrphanPageNoEx(*p);
 
-			DirectOutput().HandleReleased(Handle());
-			inputQueue.reset();
+			inputQueue.reset();		// before its backend
 		}
 	}
 
 
-	void*	X52Output::Handle() const noexcept
+	const IClock&	X52Output::Clock() const noexcept
 	{
-		return inputQueue->DeviceHandle;
-	}
-
-
-	DirectOutputInstance&	X52Output::DirectOutput() const noexcept
-	{
-		return inputQueue->Source;
+		return backend->Clock();
 	}
 
 
 	bool	X52Output::IsConnected() const noexcept
 	{
-		return DirectOutput().IsConnected(Handle());
+		return backend->IsConnected();
 	}
 
 #pragma endregion
@@ -98,8 +94,27 @@ namespace DOHelper
 	}
 
 
+	void X52Output::StartInputTrace()
+	{
+		inputQueue->StartTrace();
+	}
+
+
+	std::vector<InputMessage> X52Output::StopInputTrace()
+	{
+		return inputQueue->StopTrace();
+	}
+
+
 	void X52Output::Dispatch(const InputMessage& msg)
 	{
+		Utils::OnExitAssignment untag { handlingInput, optional<uint32_t> {} };
+		if (msg.kind != MessageKind::PageDeactivated)
+		{
+			TraceInputDispatched(msg);
+			handlingInput = msg.id;
+		}
+
 		switch (msg.kind)
 		{
 			case MessageKind::PageDeactivated:
@@ -138,10 +153,20 @@ namespace DOHelper
 					break;
 				}
 
+				Page* const next = FindPage(msg.optData);
+				if (activePage != nullptr && next != nullptr)
+					lastPagingDir = (next == PrevPage(*activePage)) ? -1 : +1;
+
 				if (Page* deact = DeactivateCurrentPage(msg.time))
 					expectedPageDeactivation = deact->Id;
 				
-				TryActivatePage(FindPage(msg.optData), msg.time);
+				if (!TryActivatePage(next, msg.time))
+				{
+					constexpr size_t MaxHints = 4;
+					if (unmatchedActivations.size() == MaxHints)
+						unmatchedActivations.erase(unmatchedActivations.begin());
+					unmatchedActivations.push_back(msg.optData);
+				}
 				break;
 			}
 
@@ -159,11 +184,11 @@ namespace DOHelper
 					break;
 				}
 
-				if (msg.optData & SoftButton_Select)
+				if (msg.optData & SoftButtonSelect)
 					activePage->OnButtonPress(msg.time);
 
-				bool up   = (msg.optData & SoftButton_Up);
-				bool down = (msg.optData & SoftButton_Down);
+				bool up   = (msg.optData & SoftButtonUp);
+				bool down = (msg.optData & SoftButtonDown);
 
 				DBG_ASSERT (!up || !down);
 				if (up)
@@ -171,7 +196,7 @@ namespace DOHelper
 				if (down)
 					activePage->OnScroll(false, msg.time);
 
-				constexpr DWORD any = SoftButton_Select | SoftButton_Up | SoftButton_Down;
+				constexpr uint32_t any = SoftButtonSelect | SoftButtonUp | SoftButtonDown;
 				DBG_ASSERT_M (0 == (msg.optData & ~any), "Unknown keypress");
 				break;
 			}
@@ -180,6 +205,45 @@ namespace DOHelper
 				DBG_BREAK;
 		}
 	}
+
+
+	void X52Output::TraceInputDispatched(const InputMessage& msg)
+	{
+		const TimePoint now = Clock().Now();
+
+		// didn't result in any change to display
+		auto expired = [&](const PendingInput& p) { return p.stamp + MaxInputLatency < now; };
+		const auto kept = std::remove_if(pendingInputs.begin(), pendingInputs.end(), expired);
+		inputLatency.unanswered += static_cast<unsigned>(pendingInputs.end() - kept);
+		pendingInputs.erase(kept, pendingInputs.end());
+
+		pendingInputs.push_back({ msg.id, msg.time, now });
+	}
+
+
+	/// A line changed by the handler of input @p inputId has been sent.
+	void X52Output::TraceInputShown(uint32_t inputId)
+	{
+		auto pos = Utils::FindIf(pendingInputs, [&](const PendingInput& p) { return p.id == inputId; });
+		if (pos == pendingInputs.end())
+			return;		// already shown by another line
+
+		const PendingInput p   = *pos;
+		const TimePoint	   now = Clock().Now();
+		pendingInputs.erase(pos);
+
+		if (p.stamp + MaxInputLatency < now)
+		{
+			++inputLatency.unanswered;
+			return;
+		}
+		inputLatency.untilDispatch.Add(p.dispatched - p.stamp);
+		inputLatency.untilDisplay.Add(now - p.dispatched);
+		inputLatency.total.Add(now - p.stamp);
+
+		auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(now - p.stamp);
+		Debug::Info(LogSource, "Input shown [ms]:", Utils::Cast::Practically<int>(ms.count()));
+	}
 	
 #pragma endregion
 
@@ -189,7 +253,7 @@ namespace DOHelper
 
 	// To avoid interpreting pending inputs addressed to an already removed Page.
 	// NOTE 1: No guarantee on theoretic level, as we can't synch with DirectOutput's internal state. Yield can help in practice.
-	// NOTE 2: Locking in InputQueue is not noexcept, but should throw only in case of program error, in which case we abort.
+	// NOTE 2: Clearing InputQueue is not noexcept due to tracing, but should throw only when out of memory, in which case we abort.
 	static void ClearForPageRemoved(InputQueue& queue) noexcept
 	{
 		std::this_thread::yield();
@@ -205,26 +269,27 @@ namespace DOHelper
 
 	bool X52Output::HasPages() const
 	{
-		return pages.empty();
+		return pageCount > 0;
 	}
 
 
 	void X52Output::AddPage(Page& p, bool activate)
 	{
-		AddPage(p, TimePoint::clock::now(), activate);
+		AddPage(p, Clock().Now(), activate);
 	}
 
 
 	void X52Output::AddPage(Page& pg, TimePoint causeStamp, bool activate)
 	{
 		LOGIC_ASSERT_M (!pg.IsAdded(), "Page already in use!");
+		LOGIC_ASSERT_M (pg.Id <= MaxPageId, "Page id out of range!");
 		LOGIC_ASSERT_M (!HasPage(pg.Id), "Duplicate page id!");
 
-		DWORD flag = activate ? FLAG_SET_AS_ACTIVE : 0;
-		pages.push_back(&pg);
+		LinkPage(pg);
 		pg.device = this;
 
-		SAI_ASSERT (DirectOutput().library->AddPage(Handle(), pg.Id, nullptr, flag));
+		SAI_ASSERT (NoteResult(backend->AddPage(pg.Id, activate)));
+		pg.ForgetLeds();
 
 		// - No Activated event raised by driver using this flag -> handle page change in place!
 		// - Deactivated gets posted though asynchronously, provided that any page was active
@@ -244,12 +309,12 @@ namespace DOHelper
 	void X52Output::ClearPages()
 	{
 		// won't receive Deactivate from DirectOutput
-		DeactivateCurrentPage(TimePoint::clock::now());
+		DeactivateCurrentPage(Clock().Now());
 
-		for (Page* p : pages)
+		for (Page* p = firstPage; p != nullptr; p = p->nextAdded)
 			OrphanPage(*p);
 
-		pages.clear();
+		UnlinkAllPages();
 		ClearForPageRemoved(*inputQueue);
 		expectedPageDeactivation.reset();
 	}
@@ -257,7 +322,7 @@ namespace DOHelper
 
 	void X52Output::RemovePage(Page& p, bool activateNeighbor)
 	{
-		RemovePage(p, TimePoint::clock::now(), activateNeighbor);
+		RemovePage(p, Clock().Now(), activateNeighbor);
 	}
 
 
@@ -267,11 +332,8 @@ namespace DOHelper
 
 		const bool wasActive = &p == activePage;
 		Page*      next      = nullptr;
-		if (wasActive && activateNeighbor && pages.size() > 1)
-		{
-			auto it = Utils::Find(pages, &p);
-			next = (it == pages.begin()) ? *(it + 1) : *(it - 1);
-		}
+		if (wasActive && activateNeighbor)
+			next = (p.prevAdded != nullptr) ? p.prevAdded : p.nextAdded;
 
 		
 		// won't receive Deactivate from DirectOutput
@@ -285,8 +347,9 @@ namespace DOHelper
 		if (next != nullptr)
 		{
 			// nice li'l hack to set active page manually
-			SAI_ASSERT (DirectOutput().library->RemovePage(Handle(), next->Id));
-			SAI_ASSERT (DirectOutput().library->AddPage(Handle(), next->Id, nullptr, FLAG_SET_AS_ACTIVE));
+			SAI_ASSERT (NoteResult(backend->RemovePage(next->Id)));
+			SAI_ASSERT (NoteResult(backend->AddPage(next->Id, true)));
+			next->ForgetLeds();
 			TryActivatePage(next, causeStamp);
 		}
 	}
@@ -316,7 +379,7 @@ namespace DOHelper
 	{
 		p.device = nullptr;
 		if (IsConnected())
-			SAI_ASSERT (DirectOutput().library->RemovePage(Handle(), p.Id));
+			SAI_ASSERT (backend->RemovePage(p.Id));
 	}
 
 
@@ -328,7 +391,7 @@ namespace DOHelper
 
 		if (p.device == this && inputQueue != nullptr && IsConnected())
 		{
-			HRESULT hr = DirectOutput().library->RemovePage(Handle(), p.Id);
+			HRESULT hr = backend->RemovePage(p.Id);
 			if (FAILED(hr))
 				Debug::Warning(LogSource, "Failed to delete page from x52 device.");
 		}
@@ -336,12 +399,11 @@ namespace DOHelper
 	}
 
 
-	/// Deletes @p p from @a pages and elects next activePage (following DirectOutput).
+	/// Deletes @p p from the added pages and elects next activePage (following DirectOutput).
 	/// @returns Found and booked (success)
-	bool X52Output::BookRemovedPage(const Page& p) noexcept
+	bool X52Output::BookRemovedPage(Page& p) noexcept
 	{
-		const auto it = Utils::Find(pages, &p);
-		if (it == pages.end())
+		if (FindPage(p.Id) != &p)
 			return false;
 
 		// Seems that DirectOutput just throws to built-in profile page.
@@ -353,7 +415,7 @@ namespace DOHelper
 			expectedPageDeactivation.reset();						// won't be received
 		}
 
-		pages.erase(it);
+		UnlinkPage(p);
 		ClearForPageRemoved(*inputQueue);
 		return true;
 	}
@@ -375,11 +437,57 @@ namespace DOHelper
 
 	auto X52Output::FindPage(uint32_t id) const noexcept -> Page*
 	{
-		auto it = Utils::FindIf(pages, [=](const Page* p) {
-			return p->Id == id;
-		});
+		return id < pagesById.size() ? pagesById[id] : nullptr;
+	}
+
+
+	/// Following page in DirectOutput's order - wrapping around.
+	auto X52Output::NextPage(const Page& p) const noexcept -> Page*
+	{
+		return p.nextAdded != nullptr ? p.nextAdded : firstPage;
+	}
+
+
+	/// Preceding page in DirectOutput's order - wrapping around.
+	auto X52Output::PrevPage(const Page& p) const noexcept -> Page*
+	{
+		return p.prevAdded != nullptr ? p.prevAdded : lastPage;
+	}
+
+
+	void X52Output::LinkPage(Page& p)
+	{
+		if (pagesById.size() <= p.Id)
+			pagesById.resize(p.Id + 1, nullptr);
+
+		pagesById[p.Id] = &p;
+		p.prevAdded		= lastPage;
+		p.nextAdded		= nullptr;
+		(lastPage != nullptr ? lastPage->nextAdded : firstPage) = &p;
+		lastPage = &p;
+		++pageCount;
+	}
+
+
+	void X52Output::UnlinkPage(Page& p) noexcept
+	{
+		DBG_ASSERT (FindPage(p.Id) == &p);
+
+		(p.prevAdded != nullptr ? p.prevAdded->nextAdded : firstPage) = p.nextAdded;
+		(p.nextAdded != nullptr ? p.nextAdded->prevAdded : lastPage)  = p.prevAdded;
+		p.prevAdded		= nullptr;
+		p.nextAdded		= nullptr;
+		pagesById[p.Id] = nullptr;
+		--pageCount;
+	}
+
+
+	void X52Output::UnlinkAllPages() noexcept
+	{
+		while (firstPage != nullptr)
+			UnlinkPage(*firstPage);
 
-		return it == pages.end() ? nullptr : *it;
+		pagesById.clear();
 	}
 
 
@@ -395,14 +503,14 @@ namespace DOHelper
 		if (activePageLagsBehind)
 			return false;
 
-		Saitek::DirectOutput& lib = *DirectOutput().library;
-		DWORD   id = activePage->Id;
-		HRESULT hr = (lib.*act)(Handle(), id, args...);
+		uint32_t id = activePage->Id;
+		HRESULT  hr = NoteResult(((*backend).*act)(id, args...));
+		++outputStats.calls;
 
 		if (SUCCEEDED(hr))
 			return true;
 
-		if (hr == E_PAGENOTACTIVE)
+		if (hr == PageNotActive)
 		{
 			activePageLagsBehind = true;
 			return false;
@@ -412,6 +520,26 @@ namespace DOHelper
 	}
 
 
+	/// A failure may belong to an earlier command, only queued when it returned S_OK (see OutputWorker).
+	HRESULT X52Output::NoteResult(HRESULT hr) noexcept
+	{
+		if (FAILED(hr))
+			ForgetSentOutput();
+		return hr;
+	}
+
+
+	// What the device displays is unsure: send lines and LEDs again on the next draw.
+	void X52Output::ForgetSentOutput() noexcept
+	{
+		sentLines.fill(Nothing);
+		for (Page* p = firstPage; p != nullptr; p = p->nextAdded)
+			p->ForgetLeds();
+		if (activePage != nullptr)
+			activePage->ForgetLines();
+	}
+
+
 	/// Virtually transactional, except the extra OnActivate-OnDeactivate pair getting called on failure.
 	/// @returns false              if @p page is not currently active according to DirectOutput
 	/// @throws DirectOutputError:  on unexpected errors during page activation
@@ -426,7 +554,8 @@ namespace DOHelper
 		try
 		{
 			activePage = page;
-			RestoreLeds();
+			sentLines.fill(Nothing);
+			FlushLeds();
 			activateCalled = true;
 			activePage->Activate(stamp);
 			if (expectedPageDeactivation == page->Id)
@@ -446,7 +575,7 @@ namespace DOHelper
 			if (activateCalled)
 				activePage->OnDeactivate(stamp);	// may throw on its own
 
-			if (err.ErrorCode == E_PAGENOTACTIVE)
+			if (err.ErrorCode == PageNotActive)
 				return false;
 			
 			throw;									// unexpected D.O. error
@@ -466,7 +595,18 @@ namespace DOHelper
 	{
 		Debug::Warning(LogSource, "Attempting to recover active page...   ");
 		
-		Page* const found = FindActivePageByProbing();
+		const TimePoint start	   = Clock().Now();
+		const unsigned	probesBefore = recoveryStats.probes;
+
+		Page* const found = FindActivePageByHints();
+
+		++recoveryStats.recoveries;
+		recoveryStats.total += Clock().Now() - start;
+		unmatchedActivations.clear();
+		Debug::Info(LogSource, "Recovery probes:", recoveryStats.probes - probesBefore);
+
+		// probing has overwritten lines, deferred commands might have failed
+		ForgetSentOutput();
 
 		if (found == activePage)
 		{
@@ -497,38 +637,96 @@ namespace DOHelper
 	}
 
 
-	auto X52Output::FindActivePageByProbing() const -> Page*
+	/// Probe the pages suggested by recent messages first, then the rest.
+	auto X52Output::FindActivePageByHints() -> Page*
 	{
-		const size_t count = pages.size();
+		std::vector<Page*> hinted;
+		auto hint = [&](optional<uint32_t> id)
+		{
+			Page* p = id.has_value() ? FindPage(*id) : nullptr;
+			if (p != nullptr && p != activePage && !Utils::Contains(hinted, p))
+				hinted.push_back(p);
+		};
 
-		size_t origo  = count;
-		size_t modulo = count + 1;		// traverse all when had no active!
-		if (activePage != nullptr)
+		// Activations we failed to follow; a page that was going to be left
+		for (auto it = unmatchedActivations.rbegin(); it != unmatchedActivations.rend(); ++it)
+			hint(*it);
+		hint(expectedPageDeactivation);
+
+		for (Page* p : hinted)
 		{
-			origo = 0;
-			while (origo < count && pages[origo]->Id != activePage->Id)
-				++origo;
+			++recoveryStats.probes;
+			if (p->ProbeActive())
+			{
+				++recoveryStats.byHint;
+				return p;
+			}
+		}
+		return FindActivePageByProbing(hinted);
+	}
 
-			DBG_ASSERT (origo < count);
-			modulo = count;
+
+	/// Outward from the last known page - first in the last paging direction.
+	auto X52Output::FindActivePageByProbing(const std::vector<Page*>& skip) -> Page*
+	{
+		auto probe = [&](Page* pg)
+		{
+			if (Utils::Contains(skip, pg))
+				return false;
+
+			++recoveryStats.probes;
+			return pg->ProbeActive();
+		};
+
+		// traverse all when had no active!
+		if (activePage == nullptr)
+		{
+			for (Page* pg = firstPage; pg != nullptr; pg = pg->nextAdded)
+			{
+				if (probe(pg))
+					return pg;
+			}
+			return nullptr;
 		}
 
-		for (size_t i = 0; i + 1 < modulo; i++)
+		Page* ahead	 = activePage;
+		Page* behind = activePage;
+		for (size_t i = 0; i + 1 < pageCount; i++)
 		{
-			size_t dist = i / 2 + 1;
-			int		dir = (i % 2) ? -1 : +1;
+			const bool forth = (i % 2 == 0) == (lastPagingDir > 0);
 
-			Page* pg = pages[(origo + dir * dist + modulo) % modulo];
-			if (pg->ProbeActive())
+			Page*& pg = (i % 2 == 0) ? ahead : behind;
+			pg = forth ? NextPage(*pg) : PrevPage(*pg);
+			if (probe(pg))
 				return pg;
 		}
 		return nullptr;
 	}
 
 
-	bool X52Output::TrySetActivePageLine(uint32_t i, uint32_t len, const wchar_t* text)
+	/// @param inputId:	tag of the input whose handling changed the line, if any
+	bool X52Output::TrySetActivePageLine(uint32_t i, uint32_t len, const wchar_t* text, optional<uint32_t> inputId)
 	{
-		return TryWithActivePage(&Saitek::DirectOutput::SetString, i, len, text);
+		DBG_ASSERT (i < sentLines.size());
+
+		optional<std::wstring>& sent = sentLines[i];
+		if (sent.has_value() && sent->compare(0, std::wstring::npos, text, len) == 0)
+		{
+			++outputStats.saved;
+			return true;
+		}
+
+		if (!TryWithActivePage(&IMfdDevice::SetString, i, len, text))
+			return false;
+
+		if (sent.has_value())
+			sent->assign(text, len);		// reuse buffer
+		else
+			sent.emplace(text, len);
+		if (inputId.has_value())
+			TraceInputShown(*inputId);
+
+		return true;
 	}
 
 #pragma endregion
@@ -539,46 +737,134 @@ namespace DOHelper
 
 #pragma region LEDs
 
+	void LedBatch::Set(BiLed id, LedColor color)
+	{
+		const uint8_t trg = static_cast<uint8_t>(color);
+		Set(static_cast<UniLed>(id),	 trg & 2);
+		Set(static_cast<UniLed>(id + 1), trg & 1);
+	}
+
+
+	void LedBatch::Set(UniLed id, bool state)
+	{
+		const uint32_t bit = 1u << id;
+		mask |= bit;
+		on	  = state ? (on | bit) : (on & ~bit);
+	}
+
+
 	void X52Output::SetColor(BiLed id, LedColor color)
 	{
-		uint8_t trg = static_cast<uint8_t>(color);
-		if (activePage)
-		{
-			SetLedComponent(id,		trg & 2);
-			SetLedComponent(id + 1, trg & 1);
-		}
+		LedBatch batch;
+		batch.Set(id, color);
+		ApplyLeds(batch);
 	}
 
 
 	void X52Output::SetState(UniLed id, bool on)
 	{
-		if (activePage)
-			SetLedComponent(id, on);
+		LedBatch batch;
+		batch.Set(id, on);
+		ApplyLeds(batch);
 	}
 
 
-	void  X52Output::SetLedComponent(uint8_t id, bool on)
+	void X52Output::ApplyLeds(const LedBatch& batch)
 	{
-		bool doSwitch = (ledStates[id] != on) && (activePage != nullptr);
-		ledStates[id] = on;
-		if (doSwitch)
-			TryWithActivePage(&Saitek::DirectOutput::SetLed, id, on);
+		DBG_ASSERT ((batch.mask >> (LedIdMax + 1)) == 0);
+
+		const uint32_t changed = batch.mask & (~ledsKnown | (ledsTarget ^ batch.on));
+		ledsKnown |= batch.mask;
+		ledsTarget = (ledsTarget & ~batch.mask) | (batch.on & batch.mask);
+		if (changed == 0 || activePage == nullptr)
+			return;
+
+		if (framing)
+			frameLedRequests += static_cast<unsigned>(std::bitset<32> { changed }.count());
+		else
+			FlushLeds();
 	}
 
 
-	void  X52Output::RestoreLeds()
+	/// Send components the active page doesn't display yet.
+	/// @returns false if active page lags behind
+	bool  X52Output::FlushLeds()
 	{
 		DBG_ASSERT (activePage != nullptr);
 
-		bool actUnchanged = true;
-		for (uint8_t id = 0; id < ledStates.size() && actUnchanged; id++)
+		Page& page = *activePage;
+		const uint32_t diff = ledsKnown & (~page.ledsSentKnown | (ledsTarget ^ page.ledsSent));
+
+		for (uint32_t id = 0; id <= LedIdMax; id++)
+		{
+			const uint32_t bit = 1u << id;
+			if ((diff & bit) == 0)
+				continue;
+
+			const bool on = ledsTarget & bit;
+			if (!TryWithActivePage(&IMfdDevice::SetLed, id, on))
+				return false;
+
+			page.ledsSentKnown |= bit;
+			page.ledsSent		= on ? (page.ledsSent | bit) : (page.ledsSent & ~bit);
+		}
+		return true;
+	}
+
+#pragma endregion
+
+
+
+#pragma region Frame
+
+	void X52Output::BeginFrame()
+	{
+		framing			 = true;
+		frameLedRequests = 0;
+	}
+
+
+	void X52Output::CommitFrame(TimePoint now)
+	{
+		constexpr Duration ReportInterval = std::chrono::seconds { 10 };
+
+		framing = false;
+		if (activePage != nullptr)
+		{
+			const unsigned callsBefore = outputStats.calls;
+			const bool     stillActive = FlushLeds();
+
+			// requested toggles collapsed into fewer calls
+			const unsigned ledCalls = outputStats.calls - callsBefore;
+			if (frameLedRequests > ledCalls)
+				outputStats.saved += frameLedRequests - ledCalls;
+
+			if (stillActive)
+				activePage->DrawLines();
+		}
+		frameLedRequests = 0;
+
+		if (now < lastReport + ReportInterval)
+			return;
+
+		if (lastReport != TimePoint {})
 		{
-			if (ledStates[id].has_value())
+			const auto	   seconds = std::chrono::duration_cast<std::chrono::seconds>(now - lastReport).count();
+			const unsigned saved   = outputStats.saved - reportedStats.saved;
+			Debug::Info(LogSource, "DirectOutput calls saved per second:", Utils::Cast::Practically<int>(saved / seconds));
+
+			using std::chrono::milliseconds;
+			const LatencyHistogram& total = inputLatency.total;
+			if (total.Count() > 0)
 			{
-				bool      on = *ledStates[id];
-				actUnchanged = TryWithActivePage(&Saitek::DirectOutput::SetLed, id, on);
+				auto p50 = std::chrono::duration_cast<milliseconds>(total.Percentile(0.5));
+				auto p95 = std::chrono::duration_cast<milliseconds>(total.Percentile(0.95));
+				Debug::Info(LogSource, "Input to display latency p50 [ms]:", Utils::Cast::Practically<int>(p50.count()));
+				Debug::Info(LogSource, "Input to display latency p95 [ms]:", Utils::Cast::Practically<int>(p95.count()));
 			}
 		}
+		reportedStats = outputStats;
+		lastReport	  = now;
 	}
 
 #pragma endregion
@@ -9,6 +9,7 @@
 
 
 #include "ScrollwheelDebounce.h"
+#include "LatencyHistogram.h"
 #include <memory>
 #include <string>
 #include <vector>
@@ -47,43 +48,111 @@ namespace DOHelper
 	};
 
 
+	/// LED components to set together - a bit per LED id.
+	struct LedBatch {
+		uint32_t	mask = 0;
+		uint32_t	on	 = 0;
+
+		void Set(BiLed, LedColor);
+		void Set(UniLed, bool on);
+	};
+
+
 	/// DirectOutput wrapper for the the functions of an X52 device.
 	/// @remarks
+	///	  *	Commands go through an IMfdDevice backend: the DirectOutput library or e.g. a VirtualX52
 	///	  *	Synchronizes bare DirectOutput events firing on various threads
 	///   *	Keeps track of the active page
 	///	  *	Provides complete page activation/deactivation events
 	///	  *	Attempts to debounce scrollwheel inputs (the API behaves suspiciously wild for me...)
 	///   *	Instead of DirectOutput's per-page LED handling, stores a global state of LEDs, which
-	///		it automatically reapplies after any page change (within the plugin)
+	///		it automatically reapplies after any page change (within the plugin) - sending only
+	///		the LEDs a page doesn't display yet
+	///	  *	Skips sending lines identical to the displayed ones. Between BeginFrame and CommitFrame
+	///		LED changes are only noted, their final state is sent once at commit.
 	class X52Output {
 	public:
 		class Page;
-		friend class DirectOutputInstance;
 
 		/// BiLeds and UniLeds in total
 		static constexpr uint32_t	LedCount = 11;
 		static constexpr uint32_t	LedIdMax = 19;
 
+		/// Page ids index a flat table
+		static constexpr uint32_t	MaxPageId = 4095;
+
+		struct OutputStats {
+			unsigned	calls = 0;		// line and LED commands sent
+			unsigned	saved = 0;		// skipped: unchanged lines, collapsed LED toggles
+		};
+
+		/// From the input's stamp till a line changed by its handler is sent.
+		struct InputLatency {
+			LatencyHistogram	untilDispatch;		// debouncing + caller's wait for input processing
+			LatencyHistogram	untilDisplay;		// handling + caller's wait for drawing
+			LatencyHistogram	total;
+			unsigned			unanswered = 0;		// nothing drawn within MaxInputLatency
+		};
+
+		static constexpr Duration	MaxInputLatency = 1s;
+
+		struct RecoveryStats {
+			unsigned	recoveries = 0;
+			unsigned	probes	   = 0;		// DirectOutput round-trips spent
+			unsigned	byHint	   = 0;		// found among the hinted pages
+			Duration	total	   = Duration::zero();
+		};
+
 	private:
-		std::unique_ptr<InputQueue> 	inputQueue;
+		std::unique_ptr<IMfdDevice>		backend;
+		std::unique_ptr<InputQueue> 	inputQueue;			// registered at backend
 		ScrollwheelDebounce				wheelDebounce;
-		std::vector<Page*>				pages;
+		Page*							firstPage				= nullptr;	// in order of adding, linked by the Pages
+		Page*							lastPage				= nullptr;
+		size_t							pageCount				= 0;
+		std::vector<Page*>				pagesById;							// added Pages at [Id]
 		Page*							activePage				= nullptr;
 		bool							activePageLagsBehind	= false;	// processing lags behind DirectOutput state
 		optional<uint32_t>				expectedPageDeactivation;			// message reorder workaround
 
-		// Treating LED colors globally within plugin
+		// Hints for recovering the active page
+		std::vector<uint32_t>			unmatchedActivations;				// newest last
+		int								lastPagingDir			= +1;
+		RecoveryStats					recoveryStats;
+
+		// Treating LED colors globally within plugin - a bit per LED id
 		// - unknown+untouched LEDs cannot be queried
 		// - this is targeted plugin state, set before commanding the device!
-		std::array<optional<bool>, 20>	ledStates;
+		// - what a page displays is tracked by the page (DirectOutput keeps LEDs per page)
+		uint32_t						ledsKnown  = 0;
+		uint32_t						ledsTarget = 0;
+
+		// What the active page displays according to the commands sent
+		std::array<optional<std::wstring>, 3>	sentLines;
+
+		bool							framing			  = false;
+		unsigned						frameLedRequests  = 0;
+		OutputStats						outputStats;
+		OutputStats						reportedStats;
+		TimePoint						lastReport;
+
+		// Inputs awaiting visible result
+		struct PendingInput {
+			uint32_t	id;
+			TimePoint	stamp;
+			TimePoint	dispatched;
+		};
+		std::vector<PendingInput>		pendingInputs;
+		optional<uint32_t>				handlingInput;		// while dispatching: tags the lines changed
+		InputLatency					inputLatency;
 
 	public:
-		X52Output(void* handle, DirectOutputInstance&);
+		explicit X52Output(std::unique_ptr<IMfdDevice>);
 		X52Output(X52Output&&) noexcept;
 		~X52Output();
 
-		void*					Handle()		const noexcept;
-		DirectOutputInstance&	DirectOutput()  const noexcept;
+		IMfdDevice&				Device()		const noexcept	{ return *backend; }
+		const IClock&			Clock()			const noexcept;
 
 		// If false, this object went stale permanently and any modifier method may throw DirectOutputError.
 		bool IsConnected() const noexcept;
@@ -96,6 +165,24 @@ namespace DOHelper
 		/// @returns	Received anything (not timed out). 
 		bool ProcessNextMessage(TimePoint waitUntil = TimePoint::max());
 
+		/// Record raw input messages (before debouncing) - to be evaluated by DebounceReplay.
+		void						StartInputTrace();
+		std::vector<InputMessage>	StopInputTrace();
+
+
+		// ---- Frame ----------------------------
+
+		/// Start collecting LED changes of the current frame.
+		void BeginFrame();
+
+		/// Send the final LED states and the active page's dirty lines.
+		/// @param now:		to report calls saved per second periodically
+		void CommitFrame(TimePoint now);
+
+		const OutputStats&	GetOutputStats()	const	{ return outputStats; }
+		const InputLatency&	GetInputLatency()	const	{ return inputLatency; }
+		const RecoveryStats&	GetRecoveryStats()	const	{ return recoveryStats; }
+
 
 		// ---- LED functions --------------------
 
@@ -106,6 +193,10 @@ namespace DOHelper
 		void 		SetColor(BiLed, LedColor);
 		void 		SetState(UniLed, bool on);
 
+		/// Set multiple LEDs at once. Only components differing from what the active page shows are sent
+		/// - at CommitFrame if framing.
+		void		ApplyLeds(const LedBatch&);
+
 
 		// ---- MFD page functions ---------------
 
@@ -127,27 +218,36 @@ namespace DOHelper
 
 	private:
 		void  Dispatch(const InputMessage&);
+		void  TraceInputDispatched(const InputMessage&);
+		void  TraceInputShown(uint32_t inputId);
 		bool  TryActivatePage(Page*, TimePoint);
 		Page* DeactivateCurrentPage(TimePoint stamp);
 
 		Page* FindPage(uint32_t id)			 const noexcept;
+		Page* NextPage(const Page&)			 const noexcept;
+		Page* PrevPage(const Page&)			 const noexcept;
+		void  LinkPage(Page&);
+		void  UnlinkPage(Page&)					   noexcept;
+		void  UnlinkAllPages()					   noexcept;
 
 		void  PageDestroys(Page&)				   noexcept;
-		bool  BookRemovedPage(const Page&)		   noexcept;
+		bool  BookRemovedPage(Page&)			   noexcept;
 		void  OrphanPageNoEx(Page&)			 const noexcept;
 		void  OrphanPage(Page&)				 const;
 
-		void  RestoreLeds();
-		void  SetLedComponent(uint8_t id, bool on);
+		bool  FlushLeds();
 
 		bool  RecoverActivePage(TimePoint);
-		Page* FindActivePageByProbing() const;
+		Page* FindActivePageByHints();
+		Page* FindActivePageByProbing(const std::vector<Page*>& skip);
 		
 		template<class SaiActionPtr, class... Args>
 		bool  TryWithActivePage(const SaiActionPtr&, const Args&...);
+		HRESULT NoteResult(HRESULT)				   noexcept;
+		void  ForgetSentOutput()				   noexcept;
 
 		// for Page (hide types instead of explicit instantiation)
-		bool  TrySetActivePageLine(uint32_t i, uint32_t len, const wchar_t* text);
+		bool  TrySetActivePageLine(uint32_t i, uint32_t len, const wchar_t* text, optional<uint32_t> inputId);
 	};
 
 
@@ -1,7 +1,6 @@
 #include "X52Page.h"
-#include "DirectOutputInstance.h"
 #include "DirectOutputError.h"
-#include "Saitek/DirectOutputImpl.h"
+#include "MfdDevice.h"
 #include "Utils/CastUtils.h"
 #include "Utils/Debug.h"
 
@@ -33,11 +32,18 @@ namespace DOHelper
 
 
 	std::wstring&   X52Output::Page::ModLine(char i)
+	{
+		MarkModified(i);
+        return lines[i];
+	}
+
+
+	void X52Output::Page::MarkModified(char i)
 	{
         LOGIC_ASSERT (i < 3);
 
-		isDirty[i] = true;
-        return lines[i];
+		NoteChange(i);
+		marquees[i].stale	= true;
 	}
 
 
@@ -48,46 +54,114 @@ namespace DOHelper
         if (!allowMarquee && text.length() > DisplayLength)
             text.resize(DisplayLength);
 
-		isDirty[i] = true;
+		NoteChange(i);
+		marquees[i].allowed	 = allowMarquee;
+		marquees[i].stale	 = true;
 		return lines[i] = std::move(text);
 	}
 
 
+	void X52Output::Page::StepMarquees(unsigned steps)
+	{
+		for (char i = 0; i < 3; i++)
+		{
+			Marquee& mq = marquees[i];
+			if (mq.stale)
+				UpdateMarquee(i);
+
+			if (mq.period > 0)
+			{
+				mq.offset  = (mq.offset + steps) % mq.period;
+				isDirty[i] = true;
+			}
+		}
+	}
+
+
+	/// Rebuild frames if the text of line @p i has changed - otherwise keep scrolling.
+	void X52Output::Page::UpdateMarquee(char i)
+	{
+		Marquee&				mq	 = marquees[i];
+		const std::wstring_view text = LineText(i);
+
+		mq.stale = false;
+		if (!mq.allowed || text.length() <= DisplayLength)
+		{
+			mq.strip.clear();
+			mq.period = 0;
+			mq.offset = 0;
+			return;
+		}
+
+		const size_t period = text.length() + MarqueeGap;
+		if (period == mq.period && mq.strip.compare(0, text.length(), text) == 0)
+			return;
+
+		mq.strip.assign(text);
+		mq.strip.append(MarqueeGap, L' ');
+		mq.strip.append(text, 0, DisplayLength);
+		mq.period = period;
+		mq.offset = 0;
+	}
+
+
 	void X52Output::Page::Activate(TimePoint stamp)
 	{
-		isDirty[0] = true;
-		isDirty[1] = true;
-		isDirty[2] = true;
+		NoteChange(0);
+		NoteChange(1);
+		NoteChange(2);
 		OnActivate(stamp);
 	}
 
 
+	// Content change - attributed to the input being handled, for latency tracing.
+	void X52Output::Page::NoteChange(char i)
+	{
+		isDirty[i] = true;
+		if (IsAdded() && device->handlingInput.has_value())
+			changedBy[i] = device->handlingInput;
+	}
+
+
 	void X52Output::Page::DrawLines()
 	{
         LOGIC_ASSERT (IsActive());
 
 		bool stillActive = true;
-        for (DWORD i = 0; i < 3 && stillActive; i++)
+        for (uint32_t i = 0; i < 3 && stillActive; i++)
         {
             if (!isDirty[i])
                 continue;
 
-            const wchar_t* s = lines[i].data();
-            DWORD        len = Practically<DWORD>(lines[i].length());
-			stillActive		 = device->TrySetActivePageLine(i, len, s);
+			if (marquees[i].stale)
+				UpdateMarquee(static_cast<char>(i));
+
+			const Marquee&			mq	 = marquees[i];
+			const std::wstring_view text = LineText(static_cast<char>(i));
+            const wchar_t* s  = mq.period > 0 ? mq.strip.data() + mq.offset : text.data();
+            uint32_t     len  = Practically<uint32_t>(mq.period > 0 ? DisplayLength : text.length());
+			stillActive		  = device->TrySetActivePageLine(i, len, s, changedBy[i]);
 			isDirty[i] = !stillActive;
+			if (stillActive)
+				changedBy[i].reset();
         }
 	}
 
 
 	bool X52Output::Page::ProbeActive() const
 	{
-        Saitek::DirectOutput& lib = *device->DirectOutput().library;
+		IMfdDevice& backend = *device->backend;
+
+		// results of deferred commands would mislead
+		backend.Flush();
 
-        DWORD   len = Practically<DWORD>(lines[0].length());
-        HRESULT hr  = lib.SetString(device->Handle(), Id, 0, len, lines[0].data());
+		const std::wstring_view text = LineText(0);
+        uint32_t len = Practically<uint32_t>(text.length());
+        HRESULT  hr  = backend.SetString(Id, 0, len, text.data());
+		if (SUCCEEDED(hr))
+			hr = backend.Flush();
 
-		if (hr == E_PAGENOTACTIVE)
+		if (hr == PageNotActive)
 			return false;
 
 		SAI_ASSERT_M (hr, "Failed to recover active page id.");
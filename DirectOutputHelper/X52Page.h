@@ -19,11 +19,31 @@ namespace DOHelper
 	public:
 		const uint32_t 			Id;
 		static constexpr size_t	DisplayLength = 16;
+		static constexpr size_t	MarqueeGap	  = 4;
 
 	private:
 		X52Output* 				device		  = nullptr;
 		std::wstring 			lines[3];
 		bool					isDirty[3]	  = { false };
+		optional<uint32_t>		changedBy[3];				// input handled when line changed
+
+		// LED state of the page according to the commands sent - bit per LED id
+		uint32_t				ledsSent	  = 0;
+		uint32_t				ledsSentKnown = 0;
+
+		// Scroll frames of a long line: DisplayLength views into strip
+		struct Marquee {
+			std::wstring		strip;					// text + gap + head of text again
+			size_t				period	= 0;			// frame count, 0: static line
+			size_t				offset	= 0;
+			bool				allowed	= false;
+			bool				stale	= false;		// line changed since frames built
+		};
+		Marquee					marquees[3];
+
+		// Neighbors in order of adding - while IsAdded
+		Page*					prevAdded	  = nullptr;
+		Page*					nextAdded	  = nullptr;
 
 	public:
 		explicit Page(uint32_t id);
@@ -44,10 +64,17 @@ namespace DOHelper
 		bool 					IsDirty()		const	{ return isDirty[0] || isDirty[1] || isDirty[2];  }
 
 		// i < 3
-		const std::wstring& 	GetLine(char i) const	{ return lines[i]; }
+		std::wstring_view	 	GetLine(char i) const	{ return LineText(i); }
 		std::wstring& 			ModLine(char i);
 		std::wstring&			SetLine(char i, std::wstring text, bool allowMarquee = false);
 
+		/// Note that line @p i has changed without ModLine - see LineText.
+		void					MarkModified(char i);
+
+		/// Scroll lines set with allowMarquee, which are longer than DisplayLength.
+		/// @remarks	Frames are prepared once per text change, a step only moves the view.
+		void StepMarquees(unsigned steps = 1);
+
 		/// Send buffered contents to X52 device.
 		void DrawLines();
 
@@ -61,6 +88,10 @@ namespace DOHelper
 
 
 		void Activate(TimePoint);
+		void NoteChange(char i);
+		void ForgetLeds()		{ ledsSent = ledsSentKnown = 0; }
+		void ForgetLines()		{ isDirty[0] = isDirty[1] = isDirty[2] = true; }
+		void UpdateMarquee(char i);
 
 		/// Workaround. Try to draw a single line. Throw only for unknown error codes.
 		/// @returns	true on Success, false on Failure due to Page is not being Active.
@@ -73,6 +104,10 @@ namespace DOHelper
 		virtual void OnDeactivate(TimePoint)		{}
 		virtual void OnButtonPress(TimePoint)		{}
 		virtual void OnScroll(bool up, TimePoint)	{}
+
+		/// Text to display as line @p i. Descendants keeping their lines elsewhere can override it
+		/// to present them directly - then instead of ModLine/SetLine, MarkModified signals changes.
+		virtual std::wstring_view LineText(char i) const	{ return lines[i]; }
 	};
 
 
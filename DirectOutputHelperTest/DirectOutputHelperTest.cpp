@@ -1,6 +1,15 @@
 #include "DirectOutputHelper/DirectOutputInstance.h"
 #include "DirectOutputHelper/X52Page.h"
+#include "DirectOutputHelper/VirtualX52.h"
+#include "DirectOutputHelper/OutputWorker.h"
+#include "DirectOutputHelper/InputQueue.h"
+#include "DirectOutputHelper/DebounceReplay.h"
+#include "DirectOutputHelper/DirectOutputError.h"
 #include "CppUnitTest.h"
+#include <deque>
+#include <random>
+#include <sstream>
+#include <thread>
 
 
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
@@ -188,7 +197,611 @@ namespace DirectOutputHelperTest
 		
 		bool WaitEventFor(Duration dur)
 		{
-			return x52.ProcessNextMessage(TimePoint::clock::now() + dur);
+			return x52.ProcessNextMessage(directOutput.Clock.Now() + dur);
+		}
+	};
+
+
+
+
+	TEST_CLASS (VirtualClockTest)
+	{
+	public:
+		TEST_METHOD (WaitWarpsToDeadline)
+		{
+			const TimePoint start = TimePoint {} + 1h;
+			VirtualClock	clock { start };
+			Assert::IsTrue(start == clock.Now());
+
+			std::mutex				mutex;
+			std::condition_variable cond;
+			std::unique_lock		lock { mutex };
+
+			const auto status = clock.WaitUntil(cond, lock, start + 10min);
+			Assert::IsTrue(std::cv_status::timeout == status);
+			Assert::IsTrue(start + 10min == clock.Now());
+		}
+
+
+		TEST_METHOD (NeverStepsBack)
+		{
+			VirtualClock clock;
+			clock.Advance(5s);
+			clock.AdvanceTo(TimePoint {} + 1s);
+			Assert::IsTrue(TimePoint {} + 5s == clock.Now());
+
+			clock.AdvanceTo(TimePoint {} + 7s);
+			Assert::IsTrue(TimePoint {} + 7s == clock.Now());
+		}
+	};
+
+
+
+	TEST_CLASS (VirtualX52Test)
+	{
+		X52Output			x52 { std::make_unique<VirtualX52>() };
+		VirtualX52&			mfd = static_cast<VirtualX52&>(x52.Device());
+
+		X52Output::Page		testPage1 { 1 };
+		X52Output::Page		testPage2 { 2 };
+
+	public:
+		TEST_METHOD_CLEANUP (Reset)
+		{
+			x52.ClearPages();
+		}
+
+
+		TEST_METHOD (DrawsActivePageOnly)
+		{
+			x52.AddPage(testPage1, true);
+			x52.AddPage(testPage2, false);
+			Assert::IsTrue(std::vector<uint32_t> { 1, 2 } == mfd.PageStack());
+			Assert::IsTrue(1 == mfd.ActivePage());
+
+			testPage1.SetLine(0, L" -- TEST 1 -- ");
+			testPage1.DrawLines();
+			Assert::IsTrue(L" -- TEST 1 -- " == mfd.DisplayedLine(0));
+			Assert::IsTrue(mfd.GetPage(2)->lines[0].empty());
+
+			x52.SetColor(BiLed::ButtonA, LedColor::Red);
+			Assert::IsTrue(1u << BiLed::ButtonA == mfd.GetPage(1)->leds);
+		}
+
+
+		TEST_METHOD (PageTurnFromDeviceThread)
+		{
+			x52.AddPage(testPage1, true);
+			x52.AddPage(testPage2, true);
+			x52.ProcessMessages(x52.Clock().Now() + 100ms);		// late Deactivated of Page 1
+			Assert::IsTrue(&testPage2 == x52.GetActivePage());
+
+			testPage1.SetLine(1, L"Back again");
+			mfd.PostPageTurn(false);
+			x52.ProcessMessages(x52.Clock().Now() + 200ms);
+
+			Assert::IsTrue(&testPage1 == x52.GetActivePage());
+			Assert::IsTrue(1 == mfd.ActivePage());
+			Assert::IsTrue(L"Back again" == mfd.DisplayedLine(1));
+		}
+
+
+		TEST_METHOD (NeighborsFollowAddOrder)
+		{
+			X52Output::Page testPage3 { 300 };
+			x52.AddPage(testPage1, false);
+			x52.AddPage(testPage3, false);
+			x52.AddPage(testPage2, true);
+			Assert::IsTrue(x52.HasPage(300) && !x52.HasPage(3));
+
+			testPage3.Remove();
+			Assert::IsFalse(x52.HasPage(300));
+
+			testPage2.Remove(true);
+			Assert::IsTrue(&testPage1 == x52.GetActivePage());
+			Assert::IsTrue(1 == mfd.ActivePage());
+
+			testPage1.Remove(true);
+			Assert::IsTrue(nullptr == x52.GetActivePage());
+			Assert::IsFalse(x52.HasPages());
+		}
+
+
+		TEST_METHOD (MarqueeScrollsLongLine)
+		{
+			x52.AddPage(testPage1, true);
+			testPage1.SetLine(0, L"KSEA SEATTLE-TACOMA INTL", true);
+			testPage1.SetLine(1, L"Short", true);
+			testPage1.DrawLines();
+			Assert::IsTrue(L"KSEA SEATTLE-TAC" == mfd.DisplayedLine(0));
+
+			const unsigned calls = mfd.CallCount();
+			testPage1.StepMarquees(5);
+			testPage1.DrawLines();
+			Assert::AreEqual(calls + 1, mfd.CallCount());
+			Assert::IsTrue(L"SEATTLE-TACOMA I" == mfd.DisplayedLine(0));
+			Assert::IsTrue(L"Short" == mfd.DisplayedLine(1));
+
+			// same text keeps position, wraps after a gap
+			testPage1.SetLine(0, L"KSEA SEATTLE-TACOMA INTL", true);
+			testPage1.StepMarquees(15);
+			testPage1.DrawLines();
+			Assert::IsTrue(L"INTL    KSEA SEA" == mfd.DisplayedLine(0));
+		}
+
+
+		TEST_METHOD (InjectedLatency)
+		{
+			mfd.CallLatency = 5ms;
+			x52.AddPage(testPage1, true);
+			const unsigned calls = mfd.CallCount();
+
+			testPage1.SetLine(0, L"1");
+			testPage1.SetLine(1, L"2");
+			testPage1.SetLine(2, L"3");
+
+			const TimePoint start = x52.Clock().Now();
+			testPage1.DrawLines();
+			Assert::IsTrue(15ms <= x52.Clock().Now() - start);
+			Assert::AreEqual(calls + 3, mfd.CallCount());
+		}
+
+
+		TEST_METHOD (CommitFrameCoalesces)
+		{
+			x52.AddPage(testPage1, true);
+			testPage1.SetLine(0, L"Same");
+			testPage1.DrawLines();
+			const unsigned calls = mfd.CallCount();
+
+			x52.BeginFrame();
+			x52.SetColor(BiLed::ButtonA, LedColor::Red);
+			x52.SetColor(BiLed::ButtonA, LedColor::Green);
+			x52.SetColor(BiLed::ButtonA, LedColor::Red);
+			testPage1.SetLine(0, L"Same");
+			x52.CommitFrame(x52.Clock().Now());
+
+			// 2 components of a single BiLed, no line
+			Assert::AreEqual(calls + 2, mfd.CallCount());
+			Assert::IsTrue(1u << BiLed::ButtonA == mfd.GetPage(1)->leds);
+			Assert::IsTrue(0 < x52.GetOutputStats().saved);
+		}
+
+
+		TEST_METHOD (LedsSentOncePerPage)
+		{
+			x52.AddPage(testPage1, true);
+			x52.SetColor(BiLed::ButtonA, LedColor::Red);
+			x52.AddPage(testPage2, true);
+			x52.ProcessMessages(x52.Clock().Now() + 100ms);
+			Assert::IsTrue(1u << BiLed::ButtonA == mfd.GetPage(2)->leds);
+
+			// Page 1 still shows the same LEDs: redraw lines only
+			unsigned calls = mfd.CallCount();
+			mfd.PostPageTurn(false);
+			x52.ProcessMessages(x52.Clock().Now() + 200ms);
+			Assert::IsTrue(&testPage1 == x52.GetActivePage());
+			Assert::AreEqual(calls + 3, mfd.CallCount());
+
+			calls = mfd.CallCount();
+			LedBatch batch;
+			batch.Set(BiLed::ButtonA, LedColor::Red);
+			batch.Set(UniLed::Fire, true);
+			x52.ApplyLeds(batch);
+			Assert::AreEqual(calls + 1, mfd.CallCount());
+			Assert::IsTrue((1u << BiLed::ButtonA | 1u << UniLed::Fire) == mfd.GetPage(1)->leds);
+		}
+
+
+		TEST_METHOD (InputLatencyTraced)
+		{
+			struct EchoPage : X52Output::Page {
+				using Page::Page;
+				void OnScroll(bool up, TimePoint) override	{ SetLine(0, up ? L"Up" : L"Down"); }
+			};
+			EchoPage echo { 3 };
+
+			x52.AddPage(echo, true);
+			const X52Output::InputLatency& latency = x52.GetInputLatency();
+
+			mfd.PostButtons(1);									// SoftButton_Select: not handled
+			x52.ProcessMessages(x52.Clock().Now() + 100ms);
+			echo.SetLine(1, L"Data");							// not its result
+			echo.DrawLines();
+			Assert::AreEqual(0u, latency.total.Count());
+
+			mfd.PostButtons(2);									// SoftButton_Up
+			x52.ProcessMessages(x52.Clock().Now() + 100ms);		// debounced at 40 ms
+			echo.DrawLines();
+			Assert::AreEqual(1u, latency.total.Count());
+			Assert::IsTrue(DebounceTiming {}.oppositePressDelay <= latency.untilDispatch.Max());
+			Assert::IsTrue(latency.untilDispatch.Max() <= latency.total.Max());
+		}
+	};
+
+
+
+	TEST_CLASS (OutputWorkerTest)
+	{
+		OutputWorker*		worker = new OutputWorker { std::make_unique<VirtualX52>() };
+		X52Output			x52 { std::unique_ptr<IMfdDevice> { worker } };
+		VirtualX52&			mfd = static_cast<VirtualX52&>(worker->Target());
+
+		X52Output::Page		testPage1 { 1 };
+
+	public:
+		TEST_METHOD_CLEANUP (Reset)
+		{
+			x52.ClearPages();
+		}
+
+
+		TEST_METHOD (CallerDoesNotWait)
+		{
+			mfd.CallLatency = 20ms;
+			x52.AddPage(testPage1, true);
+
+			const TimePoint start = x52.Clock().Now();
+			testPage1.SetLine(0, L"1");
+			testPage1.SetLine(1, L"2");
+			testPage1.SetLine(2, L"3");
+			testPage1.DrawLines();
+			Assert::IsTrue(x52.Clock().Now() - start < 20ms);
+
+			Assert::AreEqual(S_OK, worker->Flush());
+			Assert::IsTrue(L"3" == mfd.DisplayedLine(2));
+		}
+
+
+		TEST_METHOD (LastWriterWins)
+		{
+			mfd.CallLatency = 20ms;
+			x52.AddPage(testPage1, true);
+			worker->Flush();
+			const unsigned calls = mfd.CallCount();
+
+			for (const wchar_t* text : { L"1", L"2", L"3", L"4", L"5" })
+			{
+				testPage1.SetLine(0, text);
+				testPage1.DrawLines();
+			}
+			worker->Flush();
+
+			Assert::IsTrue(L"5" == mfd.DisplayedLine(0));
+			Assert::IsTrue(0 < worker->GetStats().merged);
+			Assert::IsTrue(mfd.CallCount() - calls < 5);
+		}
+
+
+		TEST_METHOD (ReportsInactivePage)
+		{
+			OutputWorker direct { std::make_unique<VirtualX52>() };
+			direct.AddPage(7, true);
+			direct.AddPage(8, true);
+
+			Assert::AreEqual(S_OK, direct.SetString(7, 0, 1, L"x"));		// deferred
+			Assert::AreEqual(PageNotActive, direct.Flush());
+			Assert::AreEqual(S_OK, direct.SetLed(8, 0, true));
+			Assert::AreEqual(S_OK, direct.Flush());
+
+			Assert::AreEqual(S_OK, direct.SetString(7, 0, 1, L"x"));
+			Assert::AreEqual(PageNotActive, direct.Flush());
+		}
+
+
+		TEST_METHOD (ReportsFailureOnce)
+		{
+			OutputWorker direct { std::make_unique<VirtualX52>() };
+			VirtualX52&	 device = static_cast<VirtualX52&>(direct.Target());
+			direct.AddPage(7, true);
+			Assert::AreEqual(S_OK, direct.Flush());
+
+			device.Disconnect();
+			Assert::AreEqual(S_OK, direct.SetLed(7, 0, true));			// deferred
+			Assert::AreEqual(E_HANDLE, direct.Flush());
+			Assert::AreEqual(S_OK, direct.Flush());						// not latched
+		}
+
+
+		TEST_METHOD (ResendsAfterDeferredFailure)
+		{
+			x52.AddPage(testPage1, true);
+			testPage1.SetLine(0, L"A");
+			testPage1.DrawLines();
+			worker->Flush();
+
+			mfd.FailNextCommand(E_FAIL);
+			const unsigned executed = worker->GetStats().executed;
+			testPage1.SetLine(0, L"B");
+			testPage1.DrawLines();										// queued: S_OK
+			while (worker->GetStats().executed == executed)
+				std::this_thread::yield();
+
+			testPage1.SetLine(1, L"C");
+			Assert::ExpectException<DirectOutputError>([this] { testPage1.DrawLines(); });
+			testPage1.DrawLines();
+			Assert::AreEqual(S_OK, worker->Flush());
+
+			Assert::IsTrue(L"B" == mfd.DisplayedLine(0));
+			Assert::IsTrue(L"C" == mfd.DisplayedLine(1));
+		}
+	};
+
+
+
+	TEST_CLASS (InputQueueTest)
+	{
+		// Invokes the input handlers right from the pressing thread.
+		class HandlerProbe final : public IMfdDevice {
+			ButtonHandler	buttonHandler  = nullptr;
+			void*			handlerContext = nullptr;
+
+		public:
+			void Press(uint32_t buttons)	{ buttonHandler(Handle(), buttons, handlerContext); }
+
+			void*			Handle()		const noexcept override		{ return const_cast<HandlerProbe*>(this); }
+			const IClock&	Clock()			const noexcept override		{ return SystemClock::Instance(); }
+			bool			IsConnected()	const noexcept override		{ return true; }
+
+			HRESULT	AddPage(uint32_t, bool)									override	{ return S_OK; }
+			HRESULT	RemovePage(uint32_t)									override	{ return S_OK; }
+			HRESULT	SetLed(uint32_t, uint32_t, bool)						override	{ return S_OK; }
+			HRESULT	SetString(uint32_t, uint32_t, uint32_t, const wchar_t*)	override	{ return S_OK; }
+
+			void RegisterInputHandlers(PageHandler, ButtonHandler onButtons, void* context) override
+			{
+				buttonHandler  = onButtons;
+				handlerContext = context;
+			}
+		};
+
+
+		// The former implementation - as reference for the benchmark.
+		class MutexDequeQueue {
+			std::mutex					mutex;
+			std::condition_variable		cond;
+			std::deque<InputMessage>	messages;
+
+		public:
+			void Push(uint32_t data)
+			{
+				{
+					std::unique_lock lock { mutex };
+					messages.push_back({ SystemClock::Instance().Now(), MessageKind::ButtonPress, data });
+				}
+				cond.notify_one();
+			}
+
+			optional<InputMessage> PopNext(const TimePoint& waitEnd)
+			{
+				std::unique_lock lock { mutex };
+				if (messages.empty())
+					cond.wait_until(lock, waitEnd);
+
+				if (messages.empty())
+					return Nothing;
+
+				InputMessage res = messages.front();
+				messages.pop_front();
+				return res;
+			}
+		};
+
+
+		static constexpr uint32_t ProducerCount = 3;
+		static constexpr uint32_t PushesEach	= 100'000;
+
+
+		// @returns messages received
+		template <class PushFun, class PopFun>
+		static unsigned RunProducers(PushFun&& push, PopFun&& pop, const char* title)
+		{
+			const TimePoint		  start = SystemClock::Instance().Now();
+			std::atomic<uint32_t> done	= 0;
+
+			std::vector<std::thread> producers;
+			for (uint32_t t = 0; t < ProducerCount; t++)
+			{
+				producers.emplace_back([&push, &done, t]
+				{
+					for (uint32_t i = 0; i < PushesEach; i++)
+						push(t * PushesEach + i);
+					++done;
+				});
+			}
+
+			unsigned received = 0;
+			bool	 finished = false;
+			while (!finished)
+			{
+				finished = done == ProducerCount;
+				while (pop(SystemClock::Instance().Now() + 1ms))
+					++received;
+			}
+			for (std::thread& t : producers)
+				t.join();
+
+			const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(SystemClock::Instance().Now() - start);
+
+			std::stringstream msg;
+			msg << title << ": " << elapsed.count() << " us, received " << received << ".\n";
+			Logger::WriteMessage(msg.str().c_str());
+			return received;
+		}
+
+	public:
+		TEST_METHOD (OrderedPerProducerOrDropped)
+		{
+			HandlerProbe device;
+			InputQueue	 queue { device };
+
+			// payload: producer's sequence number, offset by its index * PushesEach
+			std::array<optional<uint32_t>, ProducerCount> last;
+			unsigned									  outOfOrder = 0;
+
+			auto pop = [&](TimePoint waitEnd)
+			{
+				optional<InputMessage> msg = queue.PopNext(waitEnd);
+				if (msg)
+				{
+					const uint32_t producer = msg->optData / PushesEach;
+					outOfOrder += last[producer].has_value() && msg->optData <= *last[producer];
+					last[producer] = msg->optData;
+				}
+				return msg.has_value();
+			};
+
+			unsigned received = RunProducers([&](uint32_t i) { device.Press(i); }, pop, "Ring");
+
+			Assert::AreEqual(0u, outOfOrder);
+			Assert::AreEqual(ProducerCount * PushesEach, received + queue.DroppedCount());
+		}
+
+
+		TEST_METHOD (BenchmarkAgainstMutexDeque)
+		{
+			HandlerProbe	device;
+			InputQueue		ring { device };
+			MutexDequeQueue	reference;
+
+			const unsigned ringReceived = RunProducers([&](uint32_t i) { device.Press(i); },
+													   [&](TimePoint waitEnd) { return ring.PopNext(waitEnd).has_value(); },
+													   "Lock-free ring");
+
+			const unsigned refReceived	= RunProducers([&](uint32_t i) { reference.Push(i); },
+													   [&](TimePoint waitEnd) { return reference.PopNext(waitEnd).has_value(); },
+													   "Mutex + deque");
+
+			std::stringstream msg;
+			msg << "Ring dropped on overflow: " << ring.DroppedCount() << ".\n";
+			Logger::WriteMessage(msg.str().c_str());
+
+			// comparable only if both handled every push: unbounded deque, ring accounts for drops
+			Assert::AreEqual(ProducerCount * PushesEach, refReceived);
+			Assert::AreEqual(ProducerCount * PushesEach, ringReceived + ring.DroppedCount());
+			Assert::IsTrue(ringReceived > 0);
+		}
+	};
+
+
+
+	TEST_CLASS (DebounceReplayTest)
+	{
+		// as DirectOutput's SoftButton_*
+		static constexpr uint32_t Select = 1;
+		static constexpr uint32_t Up	 = 2;
+		static constexpr uint32_t Down	 = 4;
+
+		DebounceReplay	replay { Up, Down, Select };
+
+
+		static InputMessage Press(TimePoint t, uint32_t buttons)
+		{
+			return { t, MessageKind::ButtonPress, buttons };
+		}
+
+
+		// Bounces within the default windows: scroll with opposite-same pairs, press repeated.
+		static std::vector<InputTrace> SynthesizeTraces(size_t count)
+		{
+			std::mt19937							  rng { 42 };
+			std::uniform_int_distribution<int>		  action  { 0, 2 };
+			std::uniform_int_distribution<int>		  bounces { 0, 2 };
+			std::uniform_int_distribution<long long>  gapMs	  { 5, 25 };
+
+			std::vector<InputTrace> traces;
+			traces.reserve(count);
+			for (size_t i = 0; i < count; i++)
+			{
+				const TimePoint start  { std::chrono::seconds { 10 + i } };
+				const int		kind   = action(rng);
+				const uint32_t	button = kind == 0 ? Select
+									   : kind == 1 ? Up
+									   : Down;
+				const uint32_t	opposite = button ^ (Up | Down);
+
+				InputTrace trace;
+				trace.intended.push_back(Press(start, button));
+				trace.messages.push_back(Press(start, button));
+
+				TimePoint t = start;
+				for (int b = bounces(rng); b > 0; b--)
+				{
+					if (button != Select)
+					{
+						t += std::chrono::milliseconds { gapMs(rng) };
+						trace.messages.push_back(Press(t, opposite));
+					}
+					t += std::chrono::milliseconds { gapMs(rng) };
+					trace.messages.push_back(Press(t, button));
+				}
+				traces.push_back(std::move(trace));
+			}
+			return traces;
+		}
+
+
+		static void Log(const char* profile, const DebounceReport& r)
+		{
+			using std::chrono::duration_cast;
+			using std::chrono::milliseconds;
+
+			std::stringstream msg;
+			msg << profile << ": " << r.emitted << '/' << r.expected << " emitted, "
+				<< r.misclassified << " misclassified, " << r.missed << " missed, " << r.spurious << " spurious, latency mean "
+				<< duration_cast<milliseconds>(r.MeanLatency()).count() << " ms, max "
+				<< duration_cast<milliseconds>(r.maxLatency).count() << " ms.\n";
+			Logger::WriteMessage(msg.str().c_str());
+		}
+
+	public:
+		TEST_METHOD (SingleScrollAwaitsBounces)
+		{
+			const TimePoint start { std::chrono::seconds { 10 } };
+
+			auto emissions = replay.Replay({ Press(start, Up) }, DebounceTiming {});
+
+			Assert::AreEqual(size_t { 1 }, emissions.size());
+			Assert::AreEqual(Up, emissions[0].message.optData);
+			Assert::IsTrue(start + DebounceTiming {}.oppositePressDelay == emissions[0].at);
+		}
+
+
+		TEST_METHOD (TraceRoundtrip)
+		{
+			const TimePoint start { std::chrono::seconds { 10 } };
+			const std::vector<InputMessage> trace { Press(start, Up), Press(start + 15ms, Down),
+													{ start + 1s, MessageKind::PageActivated, 3 } };
+			std::stringstream ss;
+			WriteTrace(ss, trace);
+			const std::vector<InputMessage> read = ReadTrace(ss);
+
+			Assert::AreEqual(trace.size(), read.size());
+			for (size_t i = 0; i < trace.size(); i++)
+			{
+				Assert::IsTrue(trace[i].time == read[i].time);
+				Assert::IsTrue(trace[i].kind == read[i].kind);
+				Assert::AreEqual(trace[i].optData, read[i].optData);
+			}
+		}
+
+
+		TEST_METHOD (CompareTimingProfiles)
+		{
+			const std::vector<InputTrace> traces = SynthesizeTraces(3000);
+
+			const DebounceTiming defaults;
+			const DebounceTiming fast	  { 30ms, 30ms, 90ms, 400ms };
+			const DebounceTiming tight	  { 20ms, 20ms, 60ms, 300ms };
+
+			const DebounceReport byDefault = replay.Evaluate(traces, defaults);
+			Log("Default", byDefault);
+			Log("Fast",	   replay.Evaluate(traces, fast));
+			Log("Tight",   replay.Evaluate(traces, tight));
+
+			Assert::AreEqual(3000u, byDefault.traces);
+			Assert::AreEqual(0u,	byDefault.Errors());
+			Assert::IsTrue(byDefault.maxLatency <= defaults.oppositeDelayLimit);
 		}
 	};
 
@@ -151,11 +151,11 @@ namespace FSMfd
 	{
 		std::vector<DisplayVar> baseVars {
 			{ L"Accelr: ",	SimVarDef { "G FORCE",					"number",			RequestType::Real }, L"g  " },
-			{ L"IAS:",		SimVarDef { "AIRSPEED INDICATED",		"knots"				}},
-			{ L"TAS:",		SimVarDef { "AIRSPEED TRUE",			"knots"				}},
+			{ L"IAS:",		SimVarDef { "AIRSPEED INDICATED",		"knots",			RequestType::Real }, DecimalUsage { 0 } },
+			{ L"TAS:",		SimVarDef { "AIRSPEED TRUE",			"knots",			RequestType::Real }, DecimalUsage { 0 } },
 			{ L"Mach:",		SimVarDef { "AIRSPEED MACH",			"mach",				RequestType::Real }, L"   "	},
-			{ L"VSpd:",		SimVarDef { "VERTICAL SPEED",			"feet per minute",	RequestType::SignedInt }, SignUsage::PrependPlus },
-			{ L"Alt:",		SimVarDef { "PLANE ALTITUDE",			"feet"				},					 L"ft " },
+			{ L"VSpd:",		SimVarDef { "VERTICAL SPEED",			"feet per minute",	RequestType::Real }, DecimalUsage { 0, SignUsage::PrependPlus | SignUsage::AvoidNegativeZero } },
+			{ L"Alt:",		SimVarDef { "PLANE ALTITUDE",			"feet",				RequestType::Real }, DecimalUsage { 0, SignUsage::AvoidNegativeZero }, L"ft " },
 			{ L"Outside:",	SimVarDef { "AMBIENT TEMPERATURE",		"celsius",			RequestType::Real }, DecimalUsage { 1 } },
 			{ L"Press: ",	SimVarDef { "AMBIENT PRESSURE",			"millibar",			RequestType::Real }, L"mB" },
 			{ L"Dyn.P: ",	SimVarDef { "DYNAMIC PRESSURE",			"millibar",			RequestType::Real }, L"mB" },
@@ -187,9 +187,10 @@ namespace FSMfd
 			page.Add(CompactGauge { 2,  { L"/",		{ "FLAPS NUM HANDLE POSITIONS",  "number" }} }, 0);
 		}
 
-		page.Add(ColumnGauge { L"Stab%", {{ "ELEVATOR TRIM PCT", "percent", RequestType::Real }},		SignUsage::PrependPlus });
-		page.Add(ColumnGauge { L" Ail%", {{ "AILERON TRIM PCT",  "percent", RequestType::SignedInt }},	SignUsage::PrependPlus });
-		page.Add(ColumnGauge { L"Rud%",	 {{ "RUDDER TRIM PCT",   "percent", RequestType::Real }},		{ 1, SignUsage::PrependPlus }});
+		// trims move in steps: don't smooth them
+		page.Add(ColumnGauge { L"Stab%", {{ "ELEVATOR TRIM PCT", "percent", RequestType::Real,	   Smoothing::Off }},	SignUsage::PrependPlus });
+		page.Add(ColumnGauge { L" Ail%", {{ "AILERON TRIM PCT",  "percent", RequestType::SignedInt }},					SignUsage::PrependPlus });
+		page.Add(ColumnGauge { L"Rud%",	 {{ "RUDDER TRIM PCT",   "percent", RequestType::Real,	   Smoothing::Off }},	{ 1, SignUsage::PrependPlus }});
 	}
 
 
@@ -205,7 +206,7 @@ namespace FSMfd
 		panel.Add(SwitchGauge { L"FD", "AUTOPILOT FLIGHT DIRECTOR ACTIVE",	dotsAround }, 2);
 
 		// 2nd row
-		// NOTE: Would be nice to utilize DedupSimvarRegister here, but it's not worth the effort for this only use case.
+		// NOTE: The repeated condition variable is received once - SimPage derives the duplicate.
 		panel.Add(ConditionalGauge { "AUTOPILOT MANAGED SPEED IN MACH", {
 			std::make_unique<SwitchGauge>(L"Mch", "AUTOPILOT MACH HOLD",	 dotRight),
 			std::make_unique<SwitchGauge>(L"IAS", "AUTOPILOT AIRSPEED HOLD", dotRight)
@@ -236,7 +237,7 @@ namespace FSMfd
 		{
 			engStack.Add(CompactGauge { 9, DisplayVar { L"Prop", { "PROP BETA:1",			"degrees",	RequestType::SignedInt }}, false });
 			engStack.Add(CompactGauge { 7, DisplayVar { L"OiP ", { "ENG OIL PRESSURE:1",	"psi" },								L"" } }, 0);
-			engStack.Add(CompactGauge { 8, DisplayVar { L"RPM ", { "PROP RPM:1",			"RPM" }} });
+			engStack.Add(CompactGauge { 8, DisplayVar { L"RPM ", { "PROP RPM:1",			"RPM",		RequestType::Real }, DecimalUsage { 0 } } });
 			engStack.Add(CompactGauge { 7, DisplayVar { L"OiT",	 { "ENG OIL TEMPERATURE:1",	"celsius" },							L"" } });
 			if (IsPiston())
 			{
@@ -246,7 +247,7 @@ namespace FSMfd
 			}
 			else
 			{
-				engStack.Add(CompactGauge { 8, DisplayVar { L"N1",		{ "TURB ENG N1:1",					"percent" }} });
+				engStack.Add(CompactGauge { 8, DisplayVar { L"N1",		{ "TURB ENG N1:1",					"percent", RequestType::Real }, DecimalUsage { 0 } } });
 				engStack.Add(CompactGauge { 7, DisplayVar { L"FF ",		{ "RECIP ENG FUEL FLOW:1",			"pounds per hour" }, L"" } });
 				engStack.Add(CompactGauge { 8, DisplayVar { L"TQ ",		{ "ENG TORQUE:1",					"Foot pounds" },	 L"" } });
 			}
@@ -269,7 +270,7 @@ namespace FSMfd
 				{ L"EGT ",	{ "ENG EXHAUST GAS TEMPERATURE:",		"celsius"		}},
 				{ L"N1 ",	{ "TURB ENG N1:",						"percent",		RequestType::Real }, 1 },
 				{ L"N2 ",	{ "TURB ENG N2:",						"percent",		RequestType::Real }, 1 },
-				{ L"RPM",	{ "GENERAL ENG RPM:",					"RPM"			}},
+				{ L"RPM",	{ "GENERAL ENG RPM:",					"RPM",			RequestType::Real }, DecimalUsage { 0 } },
 			});
 		}
 		if (IsTurboprop() || IsPiston())
@@ -277,8 +278,8 @@ namespace FSMfd
 			engVars.insert(engVars.end(), {
 				{ L"EGT ",	 { "ENG EXHAUST GAS TEMPERATURE:",		"celsius"		}},
 				{ L"Prop ",	 { "PROP BETA:",						"degrees",		RequestType::SignedInt }},
-				{ L"PrpRPM", { "PROP RPM:",							"RPM"			}},
-				{ L"TRPM",	 { "GENERAL ENG RPM:",					"RPM"			}},
+				{ L"PrpRPM", { "PROP RPM:",							"RPM",			RequestType::Real }, DecimalUsage { 0 } },
+				{ L"TRPM",	 { "GENERAL ENG RPM:",					"RPM",			RequestType::Real }, DecimalUsage { 0 } },
 			});
 		}
 		if (IsTurboprop())
@@ -80,7 +80,7 @@ namespace FSMfd
 			if (!selected)
 				return Nothing;
 
-			X52Output x52 = directOutput.UseX52(*selected);
+			X52Output x52 = directOutput.UseX52(*selected, OutputMode::Worker);
 			if (x52.IsConnected())
 				return x52;
 
@@ -30,6 +30,12 @@ namespace FSMfd
 	}
 
 
+	namespace Pages
+	{
+		class PagePrefetcher;
+	}
+
+
 	namespace Led
 	{
 		using DOHelper::BiLed;
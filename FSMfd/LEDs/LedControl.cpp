@@ -51,8 +51,10 @@ namespace FSMfd::Led
 
 	void LedControl::ApplyDefaults()
 	{
+		DOHelper::LedBatch batch;
 		for (LedController& led : leds)
-			led.ApplyDefault(output);
+			led.ApplyDefault(batch);
+		output.ApplyLeds(batch);
 
 		stateStamp = TimePoint::min();
 		simvars.Invalidate();
@@ -63,7 +65,7 @@ namespace FSMfd::Led
 	{
 		if (!enabled)
 		{
-			client.EnableVarGroup(simvars.Group, simvars, UpdateFrequency::FrameDriven);
+			client.EnableVarGroup(simvars.Group, simvars, UpdateFrequency::FrameDriven, GroupPriority::Critical);
 			enabled = true;
 		}
 	}
@@ -85,9 +87,9 @@ namespace FSMfd::Led
 		if (now < nextBlink || !enabled)
 			return;
 
-		SwitchLeds(now, [this](LedController& led, Duration elapsed)
+		SwitchLeds(now, [](LedController& led, DOHelper::LedBatch& batch, Duration elapsed)
 		{
-			return led.Blink(output, elapsed);
+			return led.Blink(batch, elapsed);
 		});
 	}
 
@@ -99,9 +101,9 @@ namespace FSMfd::Led
 
 		const SimvarList& values = simvars.Get();
 
-		SwitchLeds(simvars.LastReceived(), [&](LedController& led, Duration elapsed)
+		SwitchLeds(simvars.LastReceived(), [&](LedController& led, DOHelper::LedBatch& batch, Duration elapsed)
 		{
-			return led.Update(output, elapsed, values);
+			return led.Update(batch, elapsed, values);
 		});
 	}
 
@@ -114,11 +116,13 @@ namespace FSMfd::Led
 		const Duration elapsed	= stamp - stateStamp;
 		Duration	   tillNext	= Duration::max();
 
+		DOHelper::LedBatch batch;
 		for (LedController& led : leds)
 		{
-			Duration hold = update(led, elapsed);
+			Duration hold = update(led, batch, elapsed);
 			tillNext = std::min(hold, tillNext);
 		}
+		output.ApplyLeds(batch);
 
 		// i.e. static color
 		bool overflow = stamp > TimePoint::max() - tillNext;
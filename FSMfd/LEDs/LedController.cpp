@@ -1,7 +1,7 @@
 #include "LedController.h"
 
 #include "IStateDetector.h"
-#include "DirectOutputHelper/X52Output.h"	// colors
+#include "DirectOutputHelper/X52Output.h"	// colors, LedBatch
 #include "Utils/Debug.h"
 
 
@@ -91,19 +91,19 @@ namespace FSMfd::Led
 	}
 
 
-	void LedController::ApplyDefault(DOHelper::X52Output& x52)
+	void LedController::ApplyDefault(DOHelper::LedBatch& batch)
 	{
-		Apply(defaultColor, x52);
+		Apply(defaultColor, batch);
 		isCurrentlyStatic = true;
 	}
 
 
-	void LedController::Apply(Color c, DOHelper::X52Output& x52)
+	void LedController::Apply(Color c, DOHelper::LedBatch& batch)
 	{
 		if (c != setColor && isMulticolor)
-			x52.SetColor(static_cast<BiLed>(ledId), c);
+			batch.Set(static_cast<BiLed>(ledId), c);
 		if (c != setColor && !isMulticolor)
-			x52.SetState(static_cast<UniLed>(ledId), c != Color::Off);
+			batch.Set(static_cast<UniLed>(ledId), c != Color::Off);
 
 		setColor = c;
 	}
@@ -131,21 +131,21 @@ namespace FSMfd::Led
 
 
 
-	Duration LedController::Update(DOHelper::X52Output& x52, Duration elapsed, const SimClient::SimvarList& simvars)
+	Duration LedController::Update(DOHelper::LedBatch& batch, Duration elapsed, const SimClient::SimvarList& simvars)
 	{
 		// It's important to always drive all the overrides -> keep potential Blinks ticking in sync
 		for (LedOverride& ovr : overrides)
 			ovr.Update(elapsed, simvars); 
 
 		auto [color, holdTime] = Summarize();
-		Apply(color, x52);
+		Apply(color, batch);
 
 		isCurrentlyStatic = (holdTime == Duration::max());
 		return holdTime;
 	}
 
 	
-	Duration LedController::Blink(DOHelper::X52Output& x52, Duration elapsed)
+	Duration LedController::Blink(DOHelper::LedBatch& batch, Duration elapsed)
 	{
 		if (isCurrentlyStatic)
 			return Duration::max();
@@ -154,7 +154,7 @@ namespace FSMfd::Led
 			ovr.AdvanceBlinking(elapsed);
 
 		auto [color, holdTime] = Summarize();
-		Apply(color, x52);
+		Apply(color, batch);
 
 		return holdTime;
 	}
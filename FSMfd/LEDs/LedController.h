@@ -88,14 +88,14 @@ namespace FSMfd::Led
 
 		void RegisterVariables(SimClient::DedupSimvarRegister&);
 
-		void ApplyDefault(DOHelper::X52Output&);
+		void ApplyDefault(DOHelper::LedBatch&);
 
 		/// @returns Duration until an upcoming Blink
-		Duration Update(DOHelper::X52Output&, Duration elapsed, const SimClient::SimvarList&);
-		Duration Blink(DOHelper::X52Output&, Duration elapsed);
+		Duration Update(DOHelper::LedBatch&, Duration elapsed, const SimClient::SimvarList&);
+		Duration Blink(DOHelper::LedBatch&, Duration elapsed);
 
 	private:
-		void Apply(Color, DOHelper::X52Output&);
+		void Apply(Color, DOHelper::LedBatch&);
 
 		std::pair<Color, Duration>	Summarize() const;
 	};
@@ -70,7 +70,7 @@ namespace FSMfd
 			}
 			x52.emplace(*std::move(found));
 
-			MfdLoop loop { Uninterrupted, FSClientName, typeMapping };
+			MfdLoop loop { Uninterrupted, FSClientName, typeMapping, directOutput.Clock };
 			loop.Run(*x52);
 		}
 		catch (const DOHelper::DirectOutputError& err)
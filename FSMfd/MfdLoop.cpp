@@ -5,11 +5,14 @@
 #include "SimClient/SimConnectError.h"
 #include "Pages/Concrete/WaitSpinner.h"
 #include "Pages/FSPageList.h"
+#include "Pages/PagePrefetcher.h"
 #include "LEDs/LedControl.h"
 
 #include "DirectOutputHelper/X52Output.h"
+#include "DirectOutputHelper/Clock.h"
 #include "Utils/Debug.h"
 #include "Utils/IoUtils.h"
+#include "Utils/StringUtils.h"
 #include <thread>
 #include <iostream>
 
@@ -21,6 +24,7 @@ namespace FSMfd
 	using namespace SimClient;
 	using Pages::FSPageList;
 	using Pages::SimPage;
+	using Pages::PagePrefetcher;
 	using Led::LedControl;
 
 
@@ -150,6 +154,12 @@ namespace FSMfd
 		
 		aircraftChanged = true;
 		Debug::Info("Aircraft changed.");
+
+		// "SimObjects\Airplanes\<folder>\aircraft.CFG" -> "<folder>"
+		const std::string_view full	  { path };
+		const size_t		   fileSep = full.find_last_of("\\/");
+		const std::string_view dir	  = full.substr(0, fileSep == full.npos ? 0 : fileSep);
+		aircraftName = dir.substr(dir.find_last_of("\\/") + 1);
 	}
 
 
@@ -159,11 +169,16 @@ namespace FSMfd
 		Pages::WaitSpinner loadingPage { L"FS20-SaiMFD", 0, L"->>-" };
 		device.AddPage(loadingPage);
 
-		TimePoint time       = TimePoint::clock::now();
+		TimePoint time       = clock.Now();
 		unsigned  configWait = 0;
 		do
 		{
-			loadingPage.SetStatus(inFlight ? L"Configuring..." : L"Load flight...");
+			if (!inFlight)
+				loadingPage.SetStatus(L"Load flight...");
+			else if (aircraftName.empty())
+				loadingPage.SetStatus(L"Configuring...");
+			else
+				loadingPage.SetStatus(L"Configuring " + Utils::String::AsDumbWString(aircraftName) + L"...");
 			loadingPage.DrawAnimation();
 			if (inFlight && configWait-- == 0)
 			{
@@ -171,7 +186,7 @@ namespace FSMfd
 				configWait = 3;			// arbitrary, but do wait a bit
 			}
 
-			AdvanceToUpcomingTick(time, WelcomeAnimationIval, TimePoint::clock::now());
+			AdvanceToUpcomingTick(time, WelcomeAnimationIval, clock.Now());
 			device.ProcessMessages(time);
 			client.ReceiveMultiple(time);
 		}
@@ -184,10 +199,11 @@ namespace FSMfd
 
 #pragma region Init+Reset
 
-	MfdLoop::MfdLoop(const volatile bool& uninterruptedFlag, const char* fSClientName, const FSTypeMapping& mapping) :
+	MfdLoop::MfdLoop(const volatile bool& uninterruptedFlag, const char* fSClientName, const FSTypeMapping& mapping, const IClock& timeSource) :
 		FSClientName  { fSClientName },
 		uninterrupted { uninterruptedFlag },
-		typeMapping   { mapping }
+		typeMapping   { mapping },
+		clock		  { timeSource }
 	{
 	}
 
@@ -240,7 +256,9 @@ namespace FSMfd
 						LedControl ledControl { device, client, config.CreateLedEffects() };
 						ledControl.ApplyDefaults();
 
-						PollFS(device, ledControl, client);
+						PagePrefetcher prefetcher { fsPages, PrewarmBudget };
+
+						PollFS(device, ledControl, client, prefetcher);
 					}
 					while (CanFlyAircraft(client));
 
@@ -267,11 +285,12 @@ namespace FSMfd
 		device.AddPage(welcomePage);
 
 		FSClient client { FSClientName, typeMapping };
+		client.SetDataBudget(FSDataBudget);
 
-		TimePoint nextCheck = TimePoint::clock::now();
+		TimePoint nextCheck = clock.Now();
 		while (CanUse(device) && !client.TryConnect())
 		{
-			AdvanceToUpcomingTick(nextCheck, WelcomeAnimationIval, TimePoint::clock::now());
+			AdvanceToUpcomingTick(nextCheck, WelcomeAnimationIval, clock.Now());
 			device.ProcessMessages(nextCheck);
 			welcomePage.DrawAnimation();
 		}
@@ -279,7 +298,7 @@ namespace FSMfd
 		optional<VersionNumber> scVer;
 		while (CanUse(device) && !scVer.has_value())
 		{
-			AdvanceToUpcomingTick(nextCheck, WelcomeAnimationIval, TimePoint::clock::now());
+			AdvanceToUpcomingTick(nextCheck, WelcomeAnimationIval, clock.Now());
 			std::ignore	= client.Receive(nextCheck);
 			scVer		= client.SimconnectVersion();
 			welcomePage.DrawAnimation();
@@ -304,14 +323,15 @@ namespace FSMfd
 
 #pragma region Page Execution
 
-	void MfdLoop::PollFS(X52Output& device, LedControl& leds, FSClient& client)
+	void MfdLoop::PollFS(X52Output& device, LedControl& leds, FSClient& client, PagePrefetcher& prefetcher)
 	{
 		LOGIC_ASSERT (Duration::zero() < HotReceiveDelay && HotReceiveDelay < BasePeriod / FSPollFreq);
 
-		const TimePoint init = TimePoint::clock::now();
+		const TimePoint init = clock.Now();
 
 		SynchClock nextAnimation { BasePeriod, AnimationFreq, init };
 		SynchClock nextUpdate	 { BasePeriod, UpdateFreq,    init };
+		SynchClock nextSmooth	 { BasePeriod, SmoothFreq,    init };
 		SynchClock nextReceive	 { BasePeriod, FSPollFreq,    init };	// page-independent
 
 		auto receiveSimBatch = [&](TimePoint now)
@@ -332,8 +352,9 @@ namespace FSMfd
 		bool devicePressed = false;
 		while (CanFlyAircraft(client) && (devicePressed || CanUse(device)))
 		{
-			const TimePoint now = TimePoint::clock::now();
+			const TimePoint now = clock.Now();
 			auto* const actPage = static_cast<SimPage*>(device.GetActivePage());
+			prefetcher.Track(actPage, now);
 
 			// 0. Wait for a Page if none active
 			//	  Keep listening for sys events
@@ -349,6 +370,7 @@ namespace FSMfd
 				continue;
 			}
 			leds.Enable();
+			device.BeginFrame();
 
 			// 1. Dispatch/Receive FS notifications
 			//	  Expedite it when Page needs it (Page change / SetSimvar caused by input)
@@ -378,6 +400,7 @@ namespace FSMfd
 					nextReceive.Reset(now, true);		// just done
 					nextAnimation.Reset(now, true);		// don't animate immediately
 					nextUpdate.Reset(now);
+					nextSmooth.Reset(now, true);
 				}
 			}
 			else if (nextReceive.IsDue(now))
@@ -397,6 +420,13 @@ namespace FSMfd
 				actPage->Update(now);
 			}
 
+			// 2.5 Smooth values between updates
+			if (nextSmooth.IsDue(now))
+			{
+				nextSmooth.Advance(now);
+				actPage->Smooth(now);
+			}
+
 			// 3. Animate
 			if (nextAnimation.IsDue(now))
 			{
@@ -404,12 +434,12 @@ namespace FSMfd
 				actPage->Animate(ticksPassed);
 			}
 
-			// 4. End "page cycle"
-			actPage->DrawLines();
+			// 4. End "page cycle": send final LED states and changed lines
+			device.CommitFrame(now);
 
 			TimePoint deadline = hotPoll 
 				? now + HotReceiveDelay
-				: Utils::Min<TimePoint>(nextReceive, nextAnimation, nextUpdate, leds.NextBlinkTime());
+				: Utils::Min<TimePoint>(nextReceive, nextAnimation, nextUpdate, nextSmooth, leds.NextBlinkTime());
 			devicePressed = device.ProcessNextMessage(deadline);
 		}
 	}
@@ -10,6 +10,7 @@
 #include "SimClient/FSClientTypes.h"
 #include "SimClient/IReceiver.h"
 #include "FSMfdTypes.h"
+#include <string>
 
 
 
@@ -21,9 +22,11 @@ namespace FSMfd
 
 		const volatile bool&			 uninterrupted;
 		const SimClient::FSTypeMapping&  typeMapping;
+		const DOHelper::IClock&			 clock;
 
 		bool							 aircraftChanged = false;
 		bool							 inFlight		 = false;
+		std::string						 aircraftName;		// folder of the last loaded aircraft
 		SimClient::NotificationCode		 codeAircraftLoaded;
 		SimClient::NotificationCode		 codeInFlight;
 		
@@ -36,17 +39,23 @@ namespace FSMfd
 		unsigned AnimationFreq   = 2;		// Local Page-logic (e.g. blink)
 		unsigned FSPollFreq      = 6;		// Receive data or events from FS
 		unsigned UpdateFreq      = 1;		// Present received data on MFD
+		unsigned SmoothFreq      = 5;		// Present extrapolated values between updates
 		Duration HotReceiveDelay = 50ms;	// Try to responsively receive data after input or Page-change
+		unsigned PrewarmBudget   = 2;		// Inactive Pages receiving data in background to be ready on Page-change
+
+		/// Bounds periodic SimConnect traffic - inactive Pages get throttled first.
+		SimClient::DataBudget FSDataBudget = { 16 * 1024, 40 };
 
 		// TODO Maybe: struct Timings { Duration a,b,c } --> Freqs
 
-		MfdLoop(const volatile bool& uninterruptedFlag, const char* fSClientName, const SimClient::FSTypeMapping&);
+		/// @remarks IClock should be the one the X52Output's DirectOutputInstance uses.
+		MfdLoop(const volatile bool& uninterruptedFlag, const char* fSClientName, const SimClient::FSTypeMapping&, const DOHelper::IClock&);
 		void Run(X52Output&);
 
 	private:
 		FSClient ConnectToFS(X52Output&);
 		void	 WaitForFlight(X52Output&, FSClient&, Configurator&);
-		void	 PollFS(X52Output&, Led::LedControl&, FSClient&);
+		void	 PollFS(X52Output&, Led::LedControl&, FSClient&, Pages::PagePrefetcher&);
 
 		bool CanUse(X52Output&)		const;
 		bool CanFlyAircraft(FSClient&)		const;
@@ -1,7 +1,6 @@
 #include "GaugeStack.h"
 
 #include "Pages/Gauges/StackableGauge.h"
-#include "Utils/Reassignable.h"
 #include "Utils/Debug.h"
 
 
@@ -62,10 +61,10 @@ namespace FSMfd::Pages
 		}
 		DBG_ASSERT (rowByLine.size() == TotalHeight());
 
-		for (const ActiveGauge& g : gauges)
+		for (ActiveGauge& g : gauges)
 		{
-			for (const SimVarDef& v : g.alg->Variables)
-				RegisterSimVar(v);
+			g.demandGroups = RegisterVariables(*g.alg);
+			SyncDemands(g);
 		}
 	}
 	
@@ -76,12 +75,13 @@ namespace FSMfd::Pages
 
 		// register first: this way a SimConnect exception won't corrupt this objects state
 		// (shouldn't build on that though)
-		for (const SimVarDef& v : next->Variables)
-			RegisterSimVar(v);
+		std::vector<DemandGroup> demandGroups = RegisterVariables(*next);
 
 		const unsigned height = next->DisplayHeight;
 
 		bool newRow = AddTo(gauges, std::move(next), margin);
+		gauges.back().demandGroups = std::move(demandGroups);
+		SyncDemands(gauges.back());
 		if (newRow)
 		{
 			const unsigned row = RowCount();
@@ -97,6 +97,7 @@ namespace FSMfd::Pages
 		}
 		LOGIC_ASSERT (scroller.LineCount() == TotalHeight());
 		AllocRowBuffer(RowCount() - 1);
+		areasMapped = false;
 
 		return *this;
 	}
@@ -131,6 +132,24 @@ namespace FSMfd::Pages
 	}
 
 
+	std::vector<SimPage::DemandGroup>  GaugeStack::RegisterVariables(const StackableGauge& g)
+	{
+		std::vector<DemandGroup> demandGroups;
+		for (unsigned s = 0; s < g.OptionalSetCount(); s++)
+			demandGroups.push_back(CreateDemandGroup());
+
+		for (SimClient::VarIdx i = 0; i < g.VarCount(); i++)
+		{
+			const unsigned set = g.OptionalSetOf(i);
+			if (set == 0)
+				RegisterSimVar(g.Variables[i]);
+			else
+				RegisterSimVar(g.Variables[i], demandGroups[set - 1]);
+		}
+		return demandGroups;
+	}
+
+
 	void GaugeStack::AllocRowBuffer(unsigned int r)
 	{
 		DBG_ASSERT_M (r + 1 < byRow.size(), "Index out of date.");
@@ -140,7 +159,7 @@ namespace FSMfd::Pages
 		const unsigned	   lines   = rowLast.alg->DisplayHeight;
 
 		for (unsigned l = 0; l < lines; l++)
-			scroller.SetLine(l + rowLast.posY, std::wstring (lineLen, L' '));
+			scroller.SetLine(l + rowLast.posY, Scroller::Line (lineLen, L' ').AsStringView());
 	}
 
 
@@ -179,7 +198,10 @@ namespace FSMfd::Pages
 
 	void GaugeStack::CleanContent()
 	{
-		ModifyDisplayAreas([&](const ActiveGauge& g, StackableGauge::DisplayArea& display) 
+		changes.Invalidate();
+
+		auto all = [](const ActiveGauge&) { return true; };
+		ModifyDisplayAreas(all, [&](const ActiveGauge& g, StackableGauge::DisplayArea& display) 
 		{
 			g.alg->Clean(display);
 		});
@@ -188,40 +210,100 @@ namespace FSMfd::Pages
 
 	void GaugeStack::UpdateContent(const SimvarList& simvars)
 	{
-		ModifyDisplayAreas([&](const ActiveGauge& g, StackableGauge::DisplayArea& display) 
+		if (!changes.Track(simvars))
+			return;
+
+		auto changed = [&](const ActiveGauge& g)
+		{
+			return changes.AnyChanged(g.firstVar, g.alg->VarCount());
+		};
+		ModifyDisplayAreas(changed, [&](const ActiveGauge& g, StackableGauge::DisplayArea& display) 
 		{
 			SimvarSublist measurements { simvars, g.firstVar, g.alg->VarCount() };
 			g.alg->Update(measurements, display);
 		});
+
+		// newly demanded values are obsolete: show layout only until they arrive,
+		// then update the whole page (those values may equal the obsolete ones)
+		auto demandsNew = [&](const ActiveGauge& g)
+		{
+			return !g.demandGroups.empty() && SyncDemands(g);
+		};
+		ModifyDisplayAreas(demandsNew, [&](const ActiveGauge& g, StackableGauge::DisplayArea& display)
+		{
+			g.alg->Clean(display);
+			changes.Invalidate();
+		});
 	}
 
 
-	template <class GaugeDisplayAction>
-	void GaugeStack::ModifyDisplayAreas(GaugeDisplayAction&& act)
+	/// @returns	Whether a new optional set got demanded.
+	bool GaugeStack::SyncDemands(const ActiveGauge& g)
 	{
-		using Utils::String::StringSection;
+		bool newDemand = false;
+		for (unsigned s = 0; s < g.demandGroups.size(); s++)
+		{
+			const bool demanded = g.alg->Demands(s + 1);
+			newDemand |= demanded && !IsDemanded(g.demandGroups[s]);
+			SetDemand(g.demandGroups[s], demanded);
+		}
+		return newDemand;
+	}
+
+
+	template <class GaugeFilter, class GaugeDisplayAction>
+	void GaugeStack::ModifyDisplayAreas(GaugeFilter&& affects, GaugeDisplayAction&& act)
+	{
+		if (!areasMapped)
+			MapDisplayAreas();
+
+		for (size_t i = 0; i < gauges.size(); i++)
+		{
+			const ActiveGauge&			 g	  = gauges[i];
+			StackableGauge::DisplayArea& area = areaByGauge[i];
+			if (!affects(g))
+				continue;
+
+			// marks the line dirty if displayed - buffer stays the same
+			for (unsigned l = 0; l < area.size; l++)
+				scroller.ModLine(g.posY + l);
+
+			act(g, area);
+		}
+	}
+
+
+	/// Resolve the display area of each gauge to sections of the scroller lines.
+	void GaugeStack::MapDisplayAreas()
+	{
+		size_t sectionCount = 0;
+		for (unsigned r = 0; r < RowCount(); r++)
+			sectionCount += (byRow[r + 1] - byRow[r]) * gauges[byRow[r]].alg->DisplayHeight;
 
-		std::vector<Utils::Reassignable<StringSection>>	area;
+		// no reallocation below: areaByGauge points into areaSections
+		areaSections.clear();
+		areaSections.reserve(sectionCount);
+		areaByGauge.clear();
+		areaByGauge.reserve(gauges.size());
 
 		for (unsigned r = 0; r < RowCount(); r++)
 		{
 			const unsigned rowHeight = gauges[byRow[r]].alg->DisplayHeight;
-			area.reserve(rowHeight);
 
 			for (size_t i = byRow[r]; i < byRow[r + 1]; i++)
 			{
-				const ActiveGauge& g = gauges[i];
-				
-				area.clear();
+				const ActiveGauge& g	 = gauges[i];
+				const size_t	   first = areaSections.size();
 				for (unsigned l = 0; l < rowHeight; l++)
 				{
-					std::wstring& buffer = scroller.ModLine(g.posY + l);
-					area.emplace_back(buffer, g.posX, g.alg->DisplayWidth);
+					Utils::String::StringSection line = scroller.ModLine(g.posY + l);
+					areaSections.emplace_back(line.SubSection(g.posX, g.alg->DisplayWidth));
 				}
-				StackableGauge::DisplayArea display { area[0].Ptr(), rowHeight };
-				act(g, display);				
+				areaByGauge.push_back({ areaSections[first].Ptr(), rowHeight });
 			}
 		}
+		DBG_ASSERT (areaSections.size() == sectionCount);
+		areasMapped = true;
 	}
 
 #pragma endregion
@@ -3,6 +3,8 @@
 #include "Pages/SimPage.h"
 #include "Pages/Scroller.h"
 #include "Pages/Gauges/StackableGauge.h"
+#include "SimClient/ChangeTracker.h"
+#include "Utils/Reassignable.h"
 #include <vector>
 
 
@@ -16,6 +18,7 @@ namespace FSMfd::Pages
 	///		each row's height is defined by the first gauge in it,
 	///		which can be followed only by smaller or same height gauges.
 	///	  *	Scrolling is multiplied around taller gauges.
+	///	  *	Optional variable sets of gauges are received only while demanded.
 	class GaugeStack final : public SimPage {
 
 		struct ActiveGauge {
@@ -23,6 +26,7 @@ namespace FSMfd::Pages
 			const SimClient::VarIdx			firstVar;
 			const unsigned					posX;
 			const unsigned					posY;
+			std::vector<DemandGroup>		demandGroups;	// for optional sets 1..
 
 			unsigned EndX() const;
 			unsigned EndY() const;
@@ -34,6 +38,13 @@ namespace FSMfd::Pages
 
 		Scroller					scroller;
 
+		// Line sections of each gauge - valid until adding
+		std::vector<Utils::Reassignable<Utils::String::StringSection>>	areaSections;
+		std::vector<StackableGauge::DisplayArea>						areaByGauge;
+		bool															areasMapped = false;
+
+		SimClient::SimvarChangeTracker	changes;
+
 	public:
 		GaugeStack(uint32_t id, const Dependencies&,
 				   SimClient::UpdateFrequency = SimClient::UpdateFrequency::PerSecond,
@@ -64,12 +75,18 @@ namespace FSMfd::Pages
 		unsigned TotalHeight()	const;		// Height in screen lines.
 
 
+		std::vector<DemandGroup>	RegisterVariables(const StackableGauge&);
+		bool						SyncDemands(const ActiveGauge&);
+
 		void AllocRowBuffer(unsigned int r);
+		void MapDisplayAreas();
 
-		template <class GaugeDisplayAction>
-		void ModifyDisplayAreas(GaugeDisplayAction&&);
+		template <class GaugeFilter, class GaugeDisplayAction>
+		void ModifyDisplayAreas(GaugeFilter&&, GaugeDisplayAction&&);
 
 		void OnScroll(bool up, TimePoint) override;
+
+		std::wstring_view LineText(char i) const override	{ return scroller.WindowLine(i); }
 	};
 
 
@@ -12,14 +12,14 @@ namespace FSMfd::Pages
 
 #pragma region Text helpers
 
-	static StringSection GetTargetField(std::wstring& line, const DisplayVar& var)
+	static StringSection GetTargetField(const StringSection& line, const DisplayVar& var)
 	{
-		return { line, var.label.length(), var.ValueRoomOn(SimPage::DisplayLength) };
+		return line.SubSection(var.label.length(), var.ValueRoomOn(SimPage::DisplayLength));
 	}
 
-	static std::array<StringSection, 3>	DissectLine(std::wstring& line, const DisplayVar& var)
+	static std::array<StringSection, 3>	DissectLine(const StringSection& line, const DisplayVar& var)
 	{
-		StringSection label { line, 0, var.label.length() };
+		StringSection label = line.SubSection(0, var.label.length());
 		StringSection num   = GetTargetField(line, var);
 		StringSection unit  = num.FollowedBy(var.unitSymbol.length());
 
@@ -27,7 +27,7 @@ namespace FSMfd::Pages
 	}
 
 
-	static void PreformatReading(std::wstring& buffer, const DisplayVar& var)
+	static void PreformatReading(const StringSection& buffer, const DisplayVar& var)
 	{
 		auto [textTrg, _, unitTrg] = DissectLine(buffer, var);
 
@@ -66,9 +66,9 @@ namespace FSMfd::Pages
 			LOGIC_ASSERT_M (var.ValueRoomOn(DisplayLength) > 0,
 							"No screenspace left for value!"  );
 
-			std::wstring text (DisplayLength, L' ');
+			Scroller::Line text (DisplayLength, L' ');
 			PreformatReading(text, var);
-			scroller.SetLine(i++, std::move(text));
+			scroller.SetLine(i++, text.AsStringView());
 
 			RegisterSimVar(var.definition);
 		}
@@ -77,6 +77,8 @@ namespace FSMfd::Pages
 
 	void ReadoutScrollList::CleanContent()
 	{
+		changes.Invalidate();
+
 		uint32_t i = 0;
 		for (const auto& [var, _] : variables)
 		{
@@ -91,8 +93,14 @@ namespace FSMfd::Pages
 		LOGIC_ASSERT (values.VarCount() == variables.size());
 		using namespace Utils::String;
 
+		if (!changes.Track(values))
+			return;
+
 		for (VarIdx i = 0; i < values.VarCount(); i++)
 		{
+			if (!changes.Changed(i))
+				continue;
+
 			const auto& [var, print] = variables[i];
 
 			StringSection field = GetTargetField(scroller.ModLine(i), var);
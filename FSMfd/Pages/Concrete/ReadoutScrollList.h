@@ -3,6 +3,7 @@
 #include "Pages/SimPage.h"
 #include "Pages/Scroller.h"
 #include "Pages/SimvarPrinter.h"
+#include "SimClient/ChangeTracker.h"
 
 
 
@@ -14,6 +15,8 @@ namespace FSMfd::Pages
 		std::vector<std::pair<DisplayVar, SimvarPrinter>>	variables;
 		
 		Scroller	scroller;
+
+		SimClient::SimvarChangeTracker	changes;
 		
 
 		void CleanContent()					  override;
@@ -21,6 +24,8 @@ namespace FSMfd::Pages
 
 		void OnScroll(bool up, TimePoint) override;
 
+		std::wstring_view LineText(char i) const override	{ return scroller.WindowLine(i); }
+
 	public:
 		ReadoutScrollList(uint32_t id, const Dependencies&, std::vector<DisplayVar>);
 	};
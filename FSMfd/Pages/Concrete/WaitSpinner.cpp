@@ -35,7 +35,7 @@ namespace FSMfd::Pages
 		if (status.length() < DisplayLength)
 			SetLine(2, AlignCenter(DisplayLength, status));
 		else
-			SetLine(2, status);
+			SetLine(2, status, true);
 	}
 
 
@@ -48,6 +48,8 @@ namespace FSMfd::Pages
 							  ? pos - 1
 							  : DisplayLength - Padding - 1;
 
+		StepMarquees();
+
 		std::wstring& line = ModLine(1);
 		line[erase] = L' ';
 		for (wchar_t c : Bar)
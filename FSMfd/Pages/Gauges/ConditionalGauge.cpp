@@ -104,6 +104,29 @@ namespace FSMfd::Pages
 	}
 
 
+	// triggers are always needed, gauge i's variables form set i + 1
+	unsigned ConditionalGauge::OptionalSetOf(SimClient::VarIdx var) const
+	{
+		unsigned set = 0;
+		while (set < varPositions.size() && varPositions[set] <= var)
+			set++;
+
+		return set;
+	}
+
+
+	unsigned ConditionalGauge::OptionalSetCount() const
+	{
+		return Implied<unsigned>(gauges.size());
+	}
+
+
+	bool ConditionalGauge::Demands(unsigned s) const
+	{
+		return s == active + 1;
+	}
+
+
 	void ConditionalGauge::Clean(DisplayArea& display)
 	{
 		gauges[active]->Clean(display);
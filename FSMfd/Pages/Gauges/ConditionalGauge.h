@@ -11,6 +11,7 @@ namespace FSMfd::Pages
 
 	/// Present one or another gauge on the same area, depending on respective triggers.
 	/// Currently implements 2 choices, but extensible if needed.
+	/// Variables of the gauges form optional sets: only the active one's are demanded.
 	class ConditionalGauge final : public StackableGauge {
 
 		/*const*/ std::array<std::unique_ptr<StackableGauge>, 2>	gauges;
@@ -32,6 +33,10 @@ namespace FSMfd::Pages
 
 		ConditionalGauge(ConditionalGauge&&) = default;
 
+		unsigned OptionalSetOf(SimClient::VarIdx)		const	override;
+		unsigned OptionalSetCount()						const	override;
+		bool	 Demands(unsigned s)					const	override;
+
 		void Clean(DisplayArea&)						override;
 		void Update(const SimvarSublist&, DisplayArea&)	override;
 	};
@@ -88,7 +88,8 @@ namespace FSMfd::Pages
 			defs.push_back(SimVarDef {
 				proto.name + std::to_string(e),
 				proto.unit,
-				proto.typeReqd
+				proto.typeReqd,
+				proto.smoothing
 			});
 		}
 		return defs;
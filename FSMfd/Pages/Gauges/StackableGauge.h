@@ -37,6 +37,15 @@ namespace FSMfd::Pages
 
 		auto VarCount() const	{ return Practically<SimClient::VarIdx>(Variables.size()); }
 
+		/// Variables needed only in some states form optional sets, numbered from 1.
+		/// @returns	The set of a Variable - 0 if always needed.
+		virtual unsigned OptionalSetOf(SimClient::VarIdx)	const	{ return 0; }
+		virtual unsigned OptionalSetCount()					const	{ return 0; }
+
+		/// Whether optional set @p s is needed in the current state.
+		/// Until its values arrive, no further Update happens.
+		virtual bool	 Demands(unsigned s)				const	{ return true; }
+
 		/// Set constant parts of layout & clear/default the values.
 		virtual void Clean(DisplayArea&)						= 0;
 
@@ -0,0 +1,83 @@
+#include "PagePrefetcher.h"
+
+#include "FSPageList.h"
+#include "Utils/BasicUtils.h"
+#include "Utils/Debug.h"
+
+
+
+namespace FSMfd::Pages
+{
+	constexpr char LogSource[] = "PagePrefetcher";
+
+
+	PagePrefetcher::PagePrefetcher(const FSPageList& pages, size_t budget) :
+		Budget { budget },
+		pages  { pages }
+	{
+		warmed.reserve(budget + 1);
+	}
+
+
+	void PagePrefetcher::Track(SimPage* activePage, TimePoint now)
+	{
+		if (activePage != active)
+			OnPageTurn(activePage, now);
+
+		if (!turnPending || activePage->IsAwaitingData())
+			return;
+
+		const Duration wait = now - turnTime;
+		turnPending = false;
+
+		stats.totalWait += wait;
+		stats.worstWait  = Utils::Max(stats.worstWait, wait);
+
+		auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(wait);
+		Debug::Info(LogSource, "Page turn to first data [ms]:", Practically<int>(ms.count()));
+	}
+
+
+	void PagePrefetcher::OnPageTurn(SimPage* activePage, TimePoint now)
+	{
+		active		= activePage;
+		turnPending = activePage != nullptr;
+		if (activePage == nullptr)
+			return;
+
+		turnTime = now;
+		++stats.turns;
+		stats.coldTurns += activePage->IsAwaitingData();
+
+		const auto& list = pages.Pages();
+		const auto	pos	 = Utils::FindIf(list, [&](const auto& p) { return p.get() == activePage; });
+		LOGIC_ASSERT_M (pos != list.end(), "Active page is not in the tracked list!");
+
+		if (pos != list.begin())
+			Touch(**(pos - 1));
+		if (pos + 1 != list.end())
+			Touch(**(pos + 1));
+		Touch(*activePage);
+
+		// Budget excludes the active page, which is MRU
+		while (warmed.size() > Budget + 1)
+		{
+			warmed.front()->SetPrewarm(false);
+			warmed.erase(warmed.begin());
+		}
+	}
+
+
+	void PagePrefetcher::Touch(SimPage& page)
+	{
+		auto pos = Utils::Find(warmed, &page);
+		if (pos != warmed.end())
+			warmed.erase(pos);
+		else
+			page.SetPrewarm(true);
+
+		warmed.push_back(&page);
+	}
+
+
+}	// namespace FSMfd::Pages
@@ -0,0 +1,57 @@
+#pragma once
+
+	/*  Part of FS20-SaiMFD			   *
+	 *  Copyright 2023 Norbert Fekete  *
+     *                                 *
+	 *  Released under GPLv3.		   */
+
+
+#include "FSMfdTypes.h"
+#include <vector>
+
+
+
+namespace FSMfd::Pages
+{
+	class SimPage;
+	class FSPageList;
+
+
+	/// Keeps the neighbors of the active page Prewarmed, so a page turn can present current data on its first frame.
+	/// @remarks
+	///		At most @a Budget inactive pages are kept prewarmed,
+	///		the least recently neighboring ones are released first.
+	///		Also measures page-turn-to-first-data latency.
+	class PagePrefetcher {
+	public:
+		struct Stats {
+			unsigned	turns		= 0;
+			unsigned	coldTurns	= 0;		// had to wait for data
+			Duration	totalWait	= Duration::zero();
+			Duration	worstWait	= Duration::zero();
+		};
+
+		const size_t			Budget;
+
+	private:
+		const FSPageList&		pages;
+		std::vector<SimPage*>	warmed;				// LRU order, MRU is the active
+		const SimPage*			active	  = nullptr;
+		TimePoint				turnTime;
+		bool					turnPending = false;
+		Stats					stats;
+
+		void OnPageTurn(SimPage*, TimePoint);
+		void Touch(SimPage&);
+
+	public:
+		PagePrefetcher(const FSPageList&, size_t budget);
+
+		/// To be called every cycle with the currently active page.
+		void Track(SimPage* activePage, TimePoint now);
+
+		const Stats& GetStats() const	{ return stats; }
+	};
+
+
+}	// namespace FSMfd::Pages
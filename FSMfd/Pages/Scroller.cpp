@@ -54,55 +54,37 @@ namespace FSMfd::Pages
 	}
 
 
-	/// @returns [Index, DisplayedNotUnseen]
-	static pair<unsigned, bool>	GetBuffIndex(unsigned i, unsigned displayPos, bool useEmptyGuards)
+	std::wstring_view		Scroller::GetLine(unsigned i) const
 	{
-		const unsigned offset = useEmptyGuards;
-		const unsigned mid	  = PubMidIdx(displayPos, useEmptyGuards);
-
-		if (i + 1 < mid)
-			return { i + offset, false };
-
-		if (mid + 1 < i)
-			return { i + offset - 3, false };
+		LOGIC_ASSERT (i < LineCount());
 
-		return { i + 1 - mid, true };
+		return lines[i + useEmptyGuards].AsStringView();
 	}
 
 
-	const std::wstring& 	Scroller::GetLine(unsigned i) const
+	Utils::String::StringSection	Scroller::ModLine(unsigned i)
 	{
 		LOGIC_ASSERT (i < LineCount());
 
-		auto [b, displayed] = GetBuffIndex(i, displayPos, useEmptyGuards);
+		if (IsDisplayed(i))
+			target.MarkModified(static_cast<char>(i + useEmptyGuards - displayPos));
 
-		return displayed 
-			? target.GetLine(b) 
-			: unseenLines[b];
+		return lines[i + useEmptyGuards];
 	}
 
 
-	std::wstring&			Scroller::ModLine(unsigned i)
+	void Pages::Scroller::SetLine(unsigned i, std::wstring_view text)
 	{
-		LOGIC_ASSERT (i < LineCount());
-
-		auto [b, displayed] = GetBuffIndex(i, displayPos, useEmptyGuards);
-
-		return displayed
-			? target.ModLine(b)
-			: unseenLines[b];
+		ModLine(i);
+		lines[i + useEmptyGuards].Assign(text);
 	}
 
 
-	void Pages::Scroller::SetLine(unsigned i, std::wstring text)
+	std::wstring_view		Scroller::WindowLine(char d) const
 	{
-		LOGIC_ASSERT (i < LineCount());
+		DBG_ASSERT (d < 3);
 
-		auto [b, displayed] = GetBuffIndex(i, displayPos, useEmptyGuards);
-		if (displayed)
-			target.SetLine(b, std::move(text), true);
-		else
-			unseenLines[b] = std::move(text);
+		return lines[displayPos + d].AsStringView();
 	}
 
 
@@ -114,7 +96,15 @@ namespace FSMfd::Pages
 
 	bool Scroller::IsBottom() const
 	{
-		return displayPos == unseenLines.size();
+		return displayPos + 3 >= lines.size();
+	}
+
+
+	// The whole window changes: a single pass over the display lines.
+	void Scroller::MarkWindowModified()
+	{
+		for (char d = 0; d < 3; d++)
+			target.MarkModified(d);
 	}
 
 
@@ -123,36 +113,27 @@ namespace FSMfd::Pages
 		if (displayPos < 1)
 			return false;
 
-		std::wstring& l0 = target.ModLine(0);
-		std::wstring& l1 = target.ModLine(1);
-		std::wstring& l2 = target.ModLine(2);
-		l2.swap(l1);
-		l1.swap(l0);
-		l0.swap(unseenLines[--displayPos]);
+		--displayPos;
+		MarkWindowModified();
 		return true;
 	}
 
 
 	bool Scroller::ScrollDown()
 	{
-		if (displayPos >= unseenLines.size())
+		if (IsBottom())
 			return false;
 
-		std::wstring& l0 = target.ModLine(0);
-		std::wstring& l1 = target.ModLine(1);
-		std::wstring& l2 = target.ModLine(2);
-		l0.swap(l1);
-		l1.swap(l2);
-		l2.swap(unseenLines[displayPos++]);
+		++displayPos;
+		MarkWindowModified();
 		return true;
 	}
 
 
 	void Scroller::AddLines(unsigned add)
 	{
-		unsigned occup = lineCount + add + 2 * useEmptyGuards;
-		if (3 < occup)
-			unseenLines.resize(occup - 3);
+		size_t occup = lineCount + add + 2 * useEmptyGuards;
+		lines.resize(std::max<size_t>(occup, 3));
 
 		lineCount += add;
 		// NOTE: No need to move the bottom empty guard - as it's just a regular empty line.
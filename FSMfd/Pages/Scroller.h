@@ -2,6 +2,7 @@
 
 #include "DirectOutputHelper/X52Page.h"
 #include "Utils/CastUtils.h"
+#include "Utils/StringUtils.h"
 
 
 
@@ -9,11 +10,19 @@ namespace FSMfd::Pages
 {
 
 	/// Helper to display 3< rows on X52 display by allowing to scroll them.
+	/// @remarks
+	///	  *	Lines are at most DisplayLength long, longer text is cut.
+	///	  *	Owns every line - the target Page should present @a WindowLine by overriding LineText.
+	///		Scrolling just moves the window, then marks the 3 display lines modified.
 	class Scroller {
+	public:
+		using Line = Utils::String::FixedLine<DOHelper::X52Output::Page::DisplayLength>;
+
+	private:
 		DOHelper::X52Output::Page&	target;
-		std::vector<std::wstring>	unseenLines;
+		std::vector<Line>			lines;			// guard lines included, min. 3
 		unsigned					lineCount;
-		unsigned					displayPos;
+		unsigned					displayPos;		// index of window top in lines
 		bool						useEmptyGuards;
 
 	public:
@@ -27,10 +36,13 @@ namespace FSMfd::Pages
 		unsigned FirstDisplayedLine() const;
 		unsigned LastDisplayedLine()  const;
 
-		bool				IsDisplayed	(unsigned i) const;
-		const std::wstring& GetLine		(unsigned i) const;
-		std::wstring&		ModLine		(unsigned i);
-		void 				SetLine		(unsigned i, std::wstring text);
+		bool							IsDisplayed	(unsigned i) const;
+		std::wstring_view				GetLine		(unsigned i) const;
+		Utils::String::StringSection	ModLine		(unsigned i);
+		void 							SetLine		(unsigned i, std::wstring_view text);
+
+		/// Text on display line @p d. @param d < 3
+		std::wstring_view				WindowLine	(char d)	 const;
 		
 		bool				IsAtop()	const;
 		bool				IsBottom()	const;
@@ -40,6 +52,9 @@ namespace FSMfd::Pages
 
 		void AddLines(unsigned count);
 		void EnsureLineCount(unsigned totalCount);
+
+	private:
+		void MarkWindowModified();
 	};
 
 
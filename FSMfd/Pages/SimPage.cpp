@@ -1,7 +1,14 @@
 #include "SimPage.h"
 
 #include "SimClient/FSClient.h"
+#include "SimClient/ConfigHelper.h"
+#include "SimClient/DedupSimvarRegister.h"
+#include "Utils/BasicUtils.h"
 #include "Utils/Debug.h"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <string_view>
 
 
 
@@ -23,55 +30,535 @@ namespace FSMfd::Pages
 	SimPage::~SimPage()
 	{
 		SimClient.TryClearVarGroup(simValues.Group);
+		if (slowValues.has_value())
+			SimClient.TryClearVarGroup(slowValues->Group);
+		for (const Demand& d : demands)
+			SimClient.TryClearVarGroup(d.values->Group);
 	}
 
 
-	void SimPage::RegisterSimVar(const SimVarDef& var)
+
+#pragma region Fast/Slow Groups
+
+	// Only well-known sluggish ones: e.g. EGT, ITT or CHT are primary engine readings.
+	static bool IsSlowlyChanging(const SimVarDef& var)
+	{
+		constexpr std::array<std::string_view, 3> slowVariables = {
+			"AMBIENT TEMPERATURE", "ENG OIL TEMPERATURE", "GENERAL ENG OIL TEMPERATURE"
+		};
+
+		// without engine index
+		const std::string_view name = std::string_view { var.name }.substr(0, var.name.find(':'));
+		return Utils::Contains(slowVariables, name);
+	}
+
+
+	// Continuous quantities, where a linear estimate between updates is meaningful.
+	// (Not degrees: headings wrap around.)
+	static bool IsSmoothlyChanging(const SimVarDef& var)
+	{
+		constexpr const char* continuousUnits[] = {
+			"percent", "knots", "mach", "feet", "ft", "ft/min", "feet per minute", "rpm",
+			"gallons per hour", "psi", "inHg", "millibar", "nautical miles"
+		};
+
+		if (var.typeReqd != RequestType::Real || var.smoothing == Smoothing::Off)
+			return false;
+
+		// units are case-insensitive for SimConnect
+		for (const char* unit : continuousUnits)
+		{
+			if (_stricmp(var.unit.c_str(), unit) == 0)
+				return true;
+		}
+		return false;
+	}
+
+
+	static UpdateFrequency SlowerOf(UpdateFrequency freq)
+	{
+		switch (freq)
+		{
+			case UpdateFrequency::FrameDriven:	return UpdateFrequency::PerSecond;
+			case UpdateFrequency::PerSecond:	return UpdateFrequency::Sparse;
+			default:							return freq;
+		}
+	}
+
+
+	/// @returns	Whether @p var could be derived from an always received one.
+	bool SimPage::TryRegisterDerived(const SimVarDef& var)
+	{
+		const VarIdx regIdx = Practically<VarIdx>(simvarCount);
+
+		// already on the wire: derive locally
+		for (VarIdx b = 0; b < regIdx; b++)
+		{
+			const VarLocation& base = varLocations[b];
+			if (base.source == VarSource::Derived || base.source == VarSource::OnDemand)
+				continue;
+
+			optional<double> scale = DedupSimvarRegister::ConversionScale(varDefinitions[b], var);
+			if (!scale.has_value())
+				continue;
+
+			if (base.source == VarSource::Fast && IsSmoothlyChanging(var))
+				smoothVars.push_back(regIdx);
+			varLocations.push_back({ VarSource::Derived, b, *scale });
+			varDefinitions.push_back(var);
+			++simvarCount;
+			++derivedVarCount;
+			return true;
+		}
+		return false;
+	}
+
+
+	void SimPage::RegisterSimVar(const SimVarDef& var, RateHint rate)
+	{
+		DBG_ASSERT_M (!mergedValues.has_value(), "Variables must be registered before activation.");
+
+		if (TryRegisterDerived(var))
+			return;
+
+		const VarIdx regIdx = Practically<VarIdx>(simvarCount);
+		const bool	 slow	= rate == RateHint::Slow
+						   || rate == RateHint::Auto && IsSlowlyChanging(var);
+		if (slow && !slowValues.has_value())
+			slowValues.emplace(SimClient.CreateVarGroup());
+
+		UniqueReceiveBuffer& target = slow ? *slowValues : simValues;
+		const size_t		 expect = slow ? slowVarCount : fastVarCount;
+
+		VarIdx vid = SimClient.AddVar(target.Group, var);
+		LOGIC_ASSERT_M (vid == expect, "Duplicate SimVar group ID?");
+
+		if (!slow && IsSmoothlyChanging(var))
+			smoothVars.push_back(regIdx);
+		varLocations.push_back({ slow ? VarSource::Slow : VarSource::Fast, vid });
+		varDefinitions.push_back(var);
+		++simvarCount;
+		fastVarCount += !slow;
+		slowVarCount += slow;
+	}
+
+
+	bool SimPage::HasAllData() const
+	{
+		for (const Demand& d : demands)
+		{
+			if (d.IsPending())
+				return false;
+		}
+		return (fastVarCount == 0 || simValues.HasData())
+			&& (!slowValues.has_value() || slowValues->HasData());
+	}
+
+
+	TimePoint SimPage::LastReceived() const
+	{
+		TimePoint last = simValues.LastReceived();
+		if (slowValues.has_value())
+			last = Utils::Max(last, slowValues->LastReceived());
+		for (const Demand& d : demands)
+			last = Utils::Max(last, d.values->LastReceived());
+
+		return last;
+	}
+
+
+	const SimvarList& SimPage::CurrentValues() const
+	{
+		DBG_ASSERT (HasAllData());
+
+		return NeedsMerge() ? *mergedValues : simValues.Get();
+	}
+
+
+	bool SimPage::NeedsMerge() const
+	{
+		return slowValues.has_value() || derivedVarCount > 0 || !demands.empty();
+	}
+
+
+	// Copies every value to its registration-order place, evaluating derived ones.
+	// (Just a few dozen dwords - no point in tracking which subgroup is fresh.)
+	void SimPage::MergeValues()
+	{
+		DBG_ASSERT (NeedsMerge() && HasAllData());
+
+		auto bufferOf = [&](const VarLocation& wire) -> const UniqueReceiveBuffer&
+		{
+			switch (wire.source)
+			{
+				case VarSource::Slow:		return *slowValues;
+				case VarSource::OnDemand:	return *demands[wire.demand].values;
+				default:					return simValues;
+			}
+		};
+
+		// layout is fixed after registration - undemanded groups may have no data yet
+		if (!mergedValues.has_value())
+		{
+			mergedPositions.reserve(simvarCount + 1);
+			mergedPositions.push_back(0);
+			for (const SimVarDef& def : varDefinitions)
+			{
+				const size_t bytes = GetSizeOf(SimClient.TypeMapping[AsIndex(def.typeReqd)]);
+				mergedPositions.push_back(mergedPositions.back() + bytes / sizeof(uint32_t));
+			}
+			mergedData.resize(mergedPositions.back());
+			mergedValues.emplace(mergedPositions, mergedData.data());
+		}
+
+		for (VarIdx i = 0; i < simvarCount; i++)
+		{
+			const VarLocation&		   loc	  = varLocations[i];
+			const VarLocation&		   wire	  = loc.source == VarSource::Derived ? varLocations[loc.index] : loc;
+			const UniqueReceiveBuffer& source = bufferOf(wire);
+			if (!source.HasData())
+				continue;		// not demanded: keeps obsolete value
+
+			const SimvarValue		   v	  = source.Get()[wire.index];
+			uint32_t*				   target = &mergedData[mergedPositions[i]];
+			memcpy(target, v.myData, (v.myEnd - v.myData) * sizeof(uint32_t));
+
+			if (loc.scale != 1.0)
+			{
+				const double converted = v.AsDouble() * loc.scale;
+				memcpy(target, &converted, sizeof(double));
+			}
+		}
+	}
+
+
+	// Drops only the groups not received in time: the others can be presented meanwhile.
+	void SimPage::InvalidateOutdated(TimePoint at)
+	{
+		const bool fast = IsFastOutdated(at);
+		const bool slow = IsSlowOutdated(at);
+
+		if (slow)
+			slowValues->Invalidate();
+		if (!fast)
+			return;
+
+		// demanded groups are received along with the fast one
+		simValues.Invalidate();
+		for (Demand& d : demands)
+			d.values->Invalidate();
+
+		snapshotPrev.clear();
+		snapshotLast.clear();
+	}
+
+#pragma endregion
+
+
+
+#pragma region Demand Groups
+
+	bool SimPage::Demand::IsPending() const
+	{
+		return demanded && varCount > 0 && !values->HasData();
+	}
+
+
+	SimPage::DemandGroup SimPage::CreateDemandGroup()
+	{
+		DBG_ASSERT_M (!mergedValues.has_value(), "Variables must be registered before activation.");
+
+		demands.push_back({ std::make_unique<UniqueReceiveBuffer>(SimClient.CreateVarGroup()) });
+		return Practically<DemandGroup>(demands.size() - 1);
+	}
+
+
+	void SimPage::RegisterSimVar(const SimVarDef& var, DemandGroup g)
+	{
+		DBG_ASSERT_M (!mergedValues.has_value(), "Variables must be registered before activation.");
+		DBG_ASSERT (g < demands.size());
+
+		if (TryRegisterDerived(var))
+			return;
+
+		Demand& d	= demands[g];
+		VarIdx	vid = SimClient.AddVar(d.values->Group, var);
+		LOGIC_ASSERT_M (vid == d.varCount, "Duplicate SimVar group ID?");
+
+		varLocations.push_back({ VarSource::OnDemand, vid, 1.0, g });
+		varDefinitions.push_back(var);
+		++simvarCount;
+		++d.varCount;
+	}
+
+
+	SimPage::Demand* SimPage::FindDemand(GroupId gid)
+	{
+		for (Demand& d : demands)
+		{
+			if (d.values->Group == gid)
+				return &d;
+		}
+		return nullptr;
+	}
+
+
+	void SimPage::SetDemand(DemandGroup g, bool demanded)
 	{
-		VarIdx vid = SimClient.AddVar(simValues.Group, var);
-		LOGIC_ASSERT_M (vid == simvarCount++, "Duplicate SimVar group ID?");
+		Demand& d = demands[g];
+		if (d.demanded == demanded)
+			return;
+
+		d.demanded = demanded;
+		if (d.varCount == 0)
+			return;
+
+		if (!demanded)
+		{
+			if (vargroupEnabled)
+				SimClient.DisableVarGroup(d.values->Group);
+			d.values->Invalidate();
+		}
+		else if (vargroupEnabled)
+		{
+			// HasAllData turns false: updates pause until its first receipt
+			SimClient.EnableVarGroup(d.values->Group, *this, enabledFreq, enabledPriority);
+		}
+	}
+
+#pragma endregion
+
+
+
+#pragma region Smoothing
+
+	void SimPage::PresentCurrentValues(TimePoint stamp, bool immediate)
+	{
+		RecordSnapshot();
+		lastUpdate = stamp;
+
+		// answers input or page change: show the newest data, interpolate onwards from it
+		if (immediate)
+			snapshotPrev = snapshotLast;
+		else if (TryPresentInterpolated(stamp))
+			return;
+
+		UpdateContent(CurrentValues());
+	}
+
+
+	void SimPage::RecordSnapshot()
+	{
+		if (smoothVars.empty() || simValues.LastReceived() == snapshotLastStamp)
+			return;
+
+		const SimvarList& current = CurrentValues();
+		const uint32_t*	  data	  = current.RawData();
+
+		snapshotPrev.swap(snapshotLast);
+		snapshotLast.assign(data, data + current.DataDWords());
+		snapshotPrevStamp = snapshotLastStamp;
+		snapshotLastStamp = simValues.LastReceived();
+	}
+
+
+	void SimPage::Smooth(TimePoint now)
+	{
+		// newer data is presented by Update
+		if (!HasAllData() || HasPendingUpdate() || HasOutdatedData(now))
+			return;
+
+		TryPresentInterpolated(now);
+	}
+
+
+	// Walks from the previous snapshot to the last one during an update period:
+	// a period late, but never beyond a received value.
+	bool SimPage::TryPresentInterpolated(TimePoint now)
+	{
+		using Seconds = std::chrono::duration<double>;
+
+		if (updateFreq != UpdateFrequency::PerSecond || snapshotPrev.empty())
+			return false;
+
+		const Duration period = snapshotLastStamp - snapshotPrevStamp;
+		if (period <= Duration::zero() || ContentAgeLimit < period)
+			return false;
+
+		const double progress = std::clamp(Seconds { now - snapshotLastStamp } / Seconds { period }, 0.0, 1.0);
+
+		const SimvarList& current = CurrentValues();
+		DBG_ASSERT (snapshotLast.size() == current.DataDWords());
+
+		smoothedData.resize(current.DataDWords());
+		const SimvarList estimate = current.CopyValues(smoothedData.data());
+
+		for (VarIdx i : smoothVars)
+		{
+			const SimvarValue v = current[i];
+			if (v.myEnd - v.myData != sizeof(double) / sizeof(uint32_t))
+				continue;
+
+			const size_t pos = v.myData - current.RawData();
+			double from, last;
+			memcpy(&from, &snapshotPrev[pos], sizeof(double));
+			memcpy(&last, &snapshotLast[pos], sizeof(double));
+
+			const double estimated = from + (last - from) * progress;
+			memcpy(&smoothedData[pos], &estimated, sizeof(double));
+		}
+		UpdateContent(estimate);
+		return true;
 	}
 
+#pragma endregion
+
+
+
+#pragma region Receive Control
 
 	void SimPage::SetUpdateFrequency(SimClient::UpdateFrequency freq)
 	{
 		updateFreq = freq;
 		if (vargroupEnabled)
 		{
-			// MAYBE: SimConnect could set frequency without disabling first
-			SimClient.DisableVarGroup(simValues.Group);
-			SimClient.EnableVarGroup(simValues.Group, *this, freq);
+			const bool reduced = prewarm && !IsActive() && !BackgroundReceiveEnabled;
+			EnableReceive(reduced ? PrewarmFrequency() : freq,
+						  IsActive() ? GroupPriority::Foreground : InactivePriority());
 		}
 	}
 
 
+	// Inactive pages only need roughly current data to present on activation.
+	UpdateFrequency SimPage::PrewarmFrequency() const
+	{
+		return SlowerOf(updateFreq);
+	}
+
+
+	// Background receivers are expected to stay current, unlike prewarmed ones.
+	GroupPriority SimPage::InactivePriority() const
+	{
+		return BackgroundReceiveEnabled ? GroupPriority::Normal : GroupPriority::Background;
+	}
+
+
+	void SimPage::EnableReceive(UpdateFrequency freq, GroupPriority prio)
+	{
+		if (vargroupEnabled && enabledFreq == freq)
+		{
+			SetReceivePriority(prio);
+			return;
+		}
+
+		// MAYBE: SimConnect could set frequency without disabling first
+		if (vargroupEnabled)
+			DisableReceive();
+
+		DBG_ASSERT (simvarCount);
+		if (fastVarCount > 0)
+			SimClient.EnableVarGroup(simValues.Group, *this, freq, prio);
+		if (slowValues.has_value())
+			SimClient.EnableVarGroup(slowValues->Group, *this, SlowerOf(freq), prio);
+		for (const Demand& d : demands)
+		{
+			if (d.demanded && d.varCount > 0)
+				SimClient.EnableVarGroup(d.values->Group, *this, freq, prio);
+		}
+
+		vargroupEnabled = true;
+		enabledFreq		= freq;
+		enabledPriority = prio;
+	}
+
+
+	void SimPage::SetReceivePriority(GroupPriority prio)
+	{
+		if (!vargroupEnabled)
+			return;
+
+		if (fastVarCount > 0)
+			SimClient.SetGroupPriority(simValues.Group, prio);
+		if (slowValues.has_value())
+			SimClient.SetGroupPriority(slowValues->Group, prio);
+		for (const Demand& d : demands)
+		{
+			if (d.demanded && d.varCount > 0)
+				SimClient.SetGroupPriority(d.values->Group, prio);
+		}
+		enabledPriority = prio;
+	}
+
+
+	void SimPage::DisableReceive()
+	{
+		if (vargroupEnabled)
+		{
+			if (fastVarCount > 0)
+				SimClient.DisableVarGroup(simValues.Group);
+			if (slowValues.has_value())
+				SimClient.DisableVarGroup(slowValues->Group);
+			for (const Demand& d : demands)
+			{
+				if (d.demanded && d.varCount > 0)
+					SimClient.DisableVarGroup(d.values->Group);
+			}
+			vargroupEnabled = false;
+		}
+	}
+
+
+	void SimPage::SetPrewarm(bool enable)
+	{
+		prewarm = enable;
+		if (IsActive() || BackgroundReceiveEnabled)
+			return;
+
+		if (enable)
+			EnableReceive(PrewarmFrequency(), GroupPriority::Background);
+		else
+			DisableReceive();
+	}
+
+#pragma endregion
+
+
+
 	void SimPage::OnActivate(TimePoint t)
 	{
+		// prewarmed at a reduced rate: such data is acceptable until regular one arrives
+		if (vargroupEnabled && enabledFreq != updateFreq)
+			reducedRateUntil = t;
+
 		const bool outdated = HasOutdatedData(t);
-		
-		if (outdated || !vargroupEnabled)
+
+		if (outdated || !vargroupEnabled || !HasAllData())
 			CleanContent();
 
 		if (outdated)
-			simValues.Invalidate();
+			InvalidateOutdated(t);
 
-		if (!vargroupEnabled)
-		{
-			DBG_ASSERT (simvarCount);
-			SimClient.EnableVarGroup(simValues.Group, *this, updateFreq);
-			vargroupEnabled = true;
-		}
+		EnableReceive(updateFreq, GroupPriority::Foreground);
+
+		// prewarmed data: present it on the very first frame
+		if (!outdated && HasAllData() && HasPendingUpdate())
+			PresentCurrentValues(LastReceived(), true);
 		// NOTE: no DrawLines yet, immediate Update can follow!
 	}
 
 
 	void SimPage::OnDeactivate(TimePoint)
 	{
-		if (!BackgroundReceiveEnabled && vargroupEnabled)
+		if (BackgroundReceiveEnabled)
 		{
-			SimClient.DisableVarGroup(simValues.Group);
-			vargroupEnabled = false;
+			SetReceivePriority(InactivePriority());
+			return;
 		}
+
+		if (prewarm)
+			EnableReceive(PrewarmFrequency(), GroupPriority::Background);
+		else
+			DisableReceive();
 	}
 
 
@@ -80,44 +567,76 @@ namespace FSMfd::Pages
 		if (HasOutdatedData(at))
 		{
 			CleanContent();
-			if (simValues.HasData())
+			if (simValues.HasData() || slowValues.has_value() && slowValues->HasData())
 			{
-				simValues.Invalidate();
+				InvalidateOutdated(at);
 				Debug::Warning("Sim data not received in time!");
 			}
 		}
-		else if (HasPendingUpdate())
+		else if (HasAllData() && HasPendingUpdate())
 		{
-			UpdateContent(simValues.Get());
-			lastUpdate = simValues.LastReceived();
+			PresentCurrentValues(LastReceived(), false);
 		}
 	}
 
 
 	bool SimPage::HasOutdatedData(TimePoint at) const
 	{
-		return updateFreq != UpdateFrequency::OnValueChange 
-			&& simValues.HasData()
-			&& simValues.LastReceived() + ContentAgeLimit < at;
+		return IsFastOutdated(at) || IsSlowOutdated(at);
+	}
+
+
+	bool SimPage::IsFastOutdated(TimePoint at) const
+	{
+		if (updateFreq == UpdateFrequency::OnValueChange)
+			return false;
+
+		const Duration limit = simValues.LastReceived() < reducedRateUntil
+							 ? ContentAgeLimit * SparseUpdateRatio
+							 : ContentAgeLimit;
+
+		return simValues.HasData()
+			&& simValues.LastReceived() + limit < at;
+	}
+
+
+	bool SimPage::IsSlowOutdated(TimePoint at) const
+	{
+		if (updateFreq == UpdateFrequency::OnValueChange)
+			return false;
+
+		return slowValues.has_value()
+			&& slowValues->HasData()
+			&& slowValues->LastReceived() + ContentAgeLimit * SparseUpdateRatio < at;
 	}
 
 
 	void SimPage::Animate(unsigned steps)
 	{
+		StepMarquees(steps);
 		StepAnimation(steps);
 	}
 
 
 	void SimPage::Receive(GroupId gid, const SimvarList& data, TimePoint stamp)
 	{
-		DBG_ASSERT_M (gid == simValues.Group, "Currently a single group per Page is expected.");
+		Demand*	   demand = FindDemand(gid);
+		const bool slow	  = slowValues.has_value() && gid == slowValues->Group;
+		DBG_ASSERT_M (demand || slow || gid == simValues.Group, "Unknown group received.");
 
-		simValues.Receive(gid, data, stamp);
-		if (BackgroundReceiveEnabled || IsAwaitingResponse())
-		{
-			UpdateContent(data);
-			lastUpdate = stamp;
-		}
+		// late packet after SetDemand(false)
+		if (demand && !demand->demanded)
+			return;
+
+		UniqueReceiveBuffer& target = demand ? *demand->values
+									: slow	 ? *slowValues
+											 : simValues;
+		target.Receive(gid, data, stamp);
+		if (NeedsMerge() && HasAllData())
+			MergeValues();
+
+		if ((BackgroundReceiveEnabled || IsAwaitingResponse()) && HasAllData())
+			PresentCurrentValues(stamp, IsAwaitingResponse());
 	}
 
 
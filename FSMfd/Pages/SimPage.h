@@ -10,6 +10,7 @@
 #include "DirectOutputHelper/X52Page.h"
 #include "SimClient/ReceiveBuffer.h"
 #include "SimClient/FSClientTypes.h"
+#include <memory>
 
 
 
@@ -31,28 +32,114 @@ namespace FSMfd::Pages
 	///		@a CleanContent's other usage is to clear obsolete data
 	///		when it is stopped being received.
 	/// 
+	///		A lighter alternative is Prewarm: an inactive page keeps receiving
+	///		at a reduced rate, just to present current data on activation.
+	/// 
+	///		The active page's groups are requested at Foreground priority,
+	///		inactive ones may get throttled by the FSClient's DataBudget.
+	/// 
+	///		Slowly changing variables (see @a RateHint) are received in a separate,
+	///		less frequent group. @a UpdateContent still gets every variable
+	///		merged in registration order.
+	/// 
+	///		A variable registered again - even in another unit of the same quantity -
+	///		is not requested twice: it is derived locally from the first one.
+	/// 
+	///		Smoothly changing variables (e.g. speeds, percents) of PerSecond pages
+	///		are interpolated between their last two snapshots by @a Smooth - presented
+	///		an update period late, so they never overshoot. Data answering input or
+	///		a page change is presented at once. @a UpdateContent receives the estimates
+	///		like normal values. See @a Smoothing to opt variables out.
+	/// 
+	///		Variables needed only in some states can form Demand Groups, received only
+	///		while demanded (@a SetDemand). Updates wait for a newly demanded group's data.
+	/// 
 	class SimPage : public DOHelper::X52Output::Page,
 					public SimClient::IDataReceiver   {
 	public:
 		struct Dependencies;
 
+		enum class RateHint { Auto, Fast, Slow };
+
 	protected:
-		using SimvarList = SimClient::SimvarList;
+		using SimvarList  = SimClient::SimvarList;
+		using DemandGroup = unsigned;
 
 		SimClient::FSClient&			SimClient;
 		const Duration					ContentAgeLimit;
 		bool							BackgroundReceiveEnabled = false;
 
 	private:
-		SimClient::UniqueReceiveBuffer	simValues;
+		enum class VarSource : uint8_t { Fast, Slow, Derived, OnDemand };
+
+		struct VarLocation {
+			VarSource			source;
+			SimClient::VarIdx	index;			// within the subgroup / registration index of base
+			double				scale  = 1.0;	// Derived: unit conversion from base
+			DemandGroup			demand = 0;		// OnDemand: owner group
+		};
+
+		struct Demand {
+			std::unique_ptr<SimClient::UniqueReceiveBuffer>	values;
+			size_t											varCount = 0;
+			bool											demanded = false;
+
+			bool IsPending() const;
+		};
+
+		SimClient::UniqueReceiveBuffer				simValues;
+		optional<SimClient::UniqueReceiveBuffer>	slowValues;
+		std::vector<Demand>							demands;
+		std::vector<VarLocation>					varLocations;		// in registration order
+		std::vector<SimVarDef>						varDefinitions;		// in registration order
+		std::vector<size_t>							mergedPositions;	// laid out on first merge
+		std::vector<uint32_t>						mergedData;
+		optional<SimvarList>						mergedValues;
+
+		// Values of the last two presented updates, for smoothing - same layout as CurrentValues
+		std::vector<SimClient::VarIdx>				smoothVars;			// fast Real ones
+		std::vector<uint32_t>						snapshotPrev;
+		std::vector<uint32_t>						snapshotLast;
+		std::vector<uint32_t>						smoothedData;
+		TimePoint									snapshotPrevStamp = TimePoint::min();
+		TimePoint									snapshotLastStamp = TimePoint::min();
+
 		SimClient::UpdateFrequency		updateFreq		 = SimClient::UpdateFrequency::PerSecond;
+		SimClient::UpdateFrequency		enabledFreq		 = SimClient::UpdateFrequency::PerSecond;
+		SimClient::GroupPriority		enabledPriority	 = SimClient::GroupPriority::Foreground;
 		TimePoint						lastUpdate		 = TimePoint::min();
+		TimePoint						reducedRateUntil = TimePoint::min();	// activation of a prewarmed page
 		size_t							simvarCount		 = 0;
+		size_t							fastVarCount	 = 0;
+		size_t							slowVarCount	 = 0;
+		size_t							derivedVarCount	 = 0;
 		bool							vargroupEnabled	 = false;
 		bool							awaitingResponse = false;
+		bool							prewarm			 = false;
 
 		
 		bool HasOutdatedData(TimePoint at) const;
+		bool IsFastOutdated(TimePoint at)	const;
+		bool IsSlowOutdated(TimePoint at)	const;
+		bool HasAllData()					const;
+		TimePoint LastReceived()			const;
+
+		bool TryRegisterDerived(const SimVarDef&);
+		Demand* FindDemand(SimClient::GroupId);
+
+		const SimvarList& CurrentValues()	const;
+		bool NeedsMerge()					const;
+		void MergeValues();
+		void InvalidateOutdated(TimePoint at);
+		void PresentCurrentValues(TimePoint stamp, bool immediate);
+		void RecordSnapshot();
+		bool TryPresentInterpolated(TimePoint now);
+
+		SimClient::UpdateFrequency PrewarmFrequency() const;
+		SimClient::GroupPriority   InactivePriority() const;
+		void EnableReceive(SimClient::UpdateFrequency, SimClient::GroupPriority);
+		void SetReceivePriority(SimClient::GroupPriority);
+		void DisableReceive();
 
 		
 		// -------- Page ------------------------------------------------
@@ -81,7 +168,22 @@ namespace FSMfd::Pages
 		SimPage(uint32_t id, const Dependencies&);
 		
 		/// To register a SimConnect variables before the page is activated.
-		void RegisterSimVar(const SimVarDef&);
+		/// @param rate:	Slow variables are received less frequently.
+		///					Auto treats ambient and oil temperatures as slow.
+		///					Ignored for derived variables: they follow their base.
+		void RegisterSimVar(const SimVarDef&, RateHint rate = RateHint::Auto);
+
+		/// Create a set of variables to be received only while demanded. Initially not demanded.
+		DemandGroup CreateDemandGroup();
+
+		/// To register a variable of a Demand Group. It is received at the fast rate,
+		/// unless derived from an always received one.
+		void RegisterSimVar(const SimVarDef&, DemandGroup);
+
+		/// Subscribe or drop a Demand Group. Its variables hold obsolete values while not demanded;
+		/// once demanded, no update is presented until its data arrives.
+		void SetDemand(DemandGroup, bool demanded);
+		bool IsDemanded(DemandGroup g) const	{ return demands[g].demanded; }
 
 		/// Set the frequency to receive updates for @a simValues.
 		void SetUpdateFrequency(SimClient::UpdateFrequency);
@@ -94,18 +196,27 @@ namespace FSMfd::Pages
 	public:
 		~SimPage() override;
 
-		bool IsAwaitingData()	   const  { return !simValues.HasData(); }
+		bool IsAwaitingData()	   const  { return !HasAllData(); }
 		bool IsAwaitingResponse()  const  { return awaitingResponse; }
 		bool IsAwaitingReceive()   const  { return IsAwaitingData() || IsAwaitingResponse(); }
-		bool HasPendingUpdate()	   const  { return lastUpdate < simValues.LastReceived(); }
+		bool HasPendingUpdate()	   const  { return lastUpdate < LastReceived(); }
+		bool IsPrewarmed()		   const  { return prewarm; }
 		TimePoint LastUpdateTime() const  { return lastUpdate;  }
 
+		/// Keep receiving data while inactive, at a reduced rate.
+		/// @remarks	Activation can present current data immediately then.
+		void SetPrewarm(bool enable);
+
 		/// Pull and display current data from game.
 		/// @param stamp:	to note LastUpdateTime - avoid unnecessary clock::now() calls.
 		void Update(TimePoint stamp);
 
 		/// Change state of blinking/moving parts, if any.
 		void Animate(unsigned stepCount = 1);
+
+		/// Between updates: present smoothly changing variables interpolated to @p now,
+		/// one update period late. No-op without enough recent snapshots.
+		void Smooth(TimePoint now);
 	};
 
 
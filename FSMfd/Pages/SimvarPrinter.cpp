@@ -15,40 +15,20 @@ namespace FSMfd::Pages
 		// MAYBE: Consider SimClient::FSTypeMapping? Currently a single signed/unsigned/fp. type can be chosen.
 		//		  FSMfd is fixed to use 32 bit integers and double.
 		//		  For strings, width can be configured freely - reading their value is independent of buffer length.
+		using Format = SimvarPrinter::Format;
 		switch (type)
 		{
 			case RequestType::Real:
-				return [=](SimvarValue val, StringSection target, PaddedAlignment aln)
-				{
-					return PlaceNumber(val.AsDouble(), options, target, aln);
-				};
+				return { Format::Real, options };
 
 			case RequestType::UnsignedInt:
-				return [](SimvarValue val, StringSection target, PaddedAlignment aln)
-				{
-					return PlaceNumber(val.AsUnsigned32(), target, aln);
-				};
+				return { Format::Unsigned, options };
 
 			case RequestType::SignedInt:
-				return [sign{options.sign}](SimvarValue val, StringSection target, PaddedAlignment aln)
-				{
-					return PlaceNumber(val.AsInt32(), sign, target, aln);
-				};
+				return { Format::Signed, options };
 
 			case RequestType::String:
-				// TODO proper string->wstring conversion for code-pages?
-				return truncableText 
-					?	[](SimvarValue val, StringSection target, PaddedAlignment aln)
-						{
-							std::wstring ws = AsDumbWString(val.AsString());
-							size_t wrote = PlaceTruncableText(ws, target, aln);
-							return wrote > 0;
-						}
-					:	[](SimvarValue val, StringSection target, PaddedAlignment aln)
-						{
-							std::wstring ws = AsDumbWString(val.AsString());
-							return PlaceText(ws, target, aln);
-						};
+				return { truncableText ? Format::TruncableText : Format::Text, options };
 
 			default:
 				DBG_BREAK;
@@ -63,4 +43,21 @@ namespace FSMfd::Pages
 	}
 
 
+	bool SimvarPrinter::operator()(SimvarValue val, StringSection target, PaddedAlignment aln) const
+	{
+		// TODO proper string->wstring conversion for code-pages?
+		//		Texts are copied straight from the receive buffer.
+		switch (format)
+		{
+			case Format::Real:			return PlaceNumber(val.AsDouble(), options, target, aln);
+			case Format::Unsigned:		return PlaceNumber(val.AsUnsigned32(), target, aln);
+			case Format::Signed:		return PlaceNumber(val.AsInt32(), options.sign, target, aln);
+			case Format::Text:			return PlaceText(val.AsString(), target, aln);
+			case Format::TruncableText:	return PlaceTruncableText(val.AsString(), target, aln) > 0;
+		}
+		DBG_BREAK;
+		return false;
+	}
+
+
 }	// namespace FSMfd::Pages
@@ -3,16 +3,27 @@
 #include "SimVarDef.h"
 #include "SimClient/IReceiver.h"
 #include "Utils/StringUtils.h"
-#include <functional>
 
 
 
 namespace FSMfd::Pages
 {
 
-	using SimvarPrinter = std::function<bool (SimClient::SimvarValue,
-											  Utils::String::StringSection, 
-											  Utils::String::PaddedAlignment)>;
+	/// Prints SimvarValues of a type chosen at construction - see CreatePrinterFor.
+	/// @remarks	A closed set of formats: no indirect calls or allocations while printing.
+	class SimvarPrinter {
+		enum class Format : uint8_t { Real, Unsigned, Signed, Text, TruncableText };
+
+		Format							format;
+		Utils::String::DecimalUsage		options;		// Signed uses the sign only
+
+		SimvarPrinter(Format f, Utils::String::DecimalUsage opts) : format { f }, options { opts }	{}
+
+		friend SimvarPrinter CreatePrinterFor(RequestType, Utils::String::DecimalUsage, bool);
+
+	public:
+		bool operator()(SimClient::SimvarValue, Utils::String::StringSection, Utils::String::PaddedAlignment) const;
+	};
 
 
 	SimvarPrinter CreatePrinterFor(RequestType, Utils::String::DecimalUsage = 2, bool truncableText = false);
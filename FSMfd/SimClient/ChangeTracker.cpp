@@ -0,0 +1,73 @@
+#include "ChangeTracker.h"
+
+#include "Utils/Debug.h"
+#include <algorithm>
+#include <cstring>
+
+
+
+namespace FSMfd::SimClient
+{
+
+	bool SimvarChangeTracker::Track(const SimvarList& list)
+	{
+		const VarIdx	count  = list.VarCount();
+		const size_t	dwords = list.DataDWords();
+		const uint32_t*	data   = list.RawData();
+
+		auto posOf = [&](VarIdx i) -> size_t
+		{
+			return i < count ? list[i].myData - data : dwords;
+		};
+
+		bool sameLayout = valid && lastPositions.size() == count + size_t { 1 };
+		for (VarIdx i = 0; sameLayout && i <= count; i++)
+			sameLayout = lastPositions[i] == posOf(i);
+
+		// common case: the whole packet is bit-identical
+		if (sameLayout && memcmp(lastData.data(), data, dwords * sizeof(uint32_t)) == 0)
+		{
+			std::fill(changed.begin(), changed.end(), false);
+			return false;
+		}
+
+		changed.resize(count);
+		for (VarIdx i = 0; i < count; i++)
+		{
+			const size_t pos = posOf(i);
+			const size_t len = posOf(i + 1) - pos;
+			changed[i] = !sameLayout
+					  || memcmp(lastData.data() + pos, data + pos, len * sizeof(uint32_t)) != 0;
+		}
+
+		if (!sameLayout)
+		{
+			lastPositions.resize(count + size_t { 1 });
+			for (VarIdx i = 0; i <= count; i++)
+				lastPositions[i] = posOf(i);
+		}
+		lastData.assign(data, data + dwords);
+		valid = true;
+
+		return true;
+	}
+
+
+	bool SimvarChangeTracker::Changed(VarIdx i) const
+	{
+		DBG_ASSERT (valid && i < changed.size());
+
+		return changed[i];
+	}
+
+
+	bool SimvarChangeTracker::AnyChanged(VarIdx first, VarIdx n) const
+	{
+		DBG_ASSERT (valid && first + n <= changed.size());
+
+		auto begin = changed.begin() + first;
+		return std::find(begin, begin + n, true) != begin + n;
+	}
+
+
+}	// namespace FSMfd::SimClient
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "IReceiver.h"
+#include <vector>
+
+
+
+namespace FSMfd::SimClient
+{
+
+	/// Remembers the raw dwords of the last processed @a SimvarList,
+	/// so displays can skip re-formatting values that did not change.
+	class SimvarChangeTracker {
+		std::vector<uint32_t>	lastData;
+		std::vector<size_t>		lastPositions;		// last denotes end of data
+		std::vector<bool>		changed;
+		bool					valid = false;
+
+	public:
+		/// Compare @p list to the previously tracked one, then remember it.
+		/// @returns	whether any variable differs
+		bool Track(const SimvarList& list);
+
+		/// Results of last @a Track.
+		bool Changed(VarIdx)					const;
+		bool AnyChanged(VarIdx first, VarIdx n)	const;
+
+		/// Report every variable as changed on next @a Track.
+		void Invalidate()	{ valid = false; }
+	};
+
+
+}	// namespace FSMfd::SimClient
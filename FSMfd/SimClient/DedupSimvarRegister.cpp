@@ -1,13 +1,43 @@
 #include "DedupSimvarRegister.h"
 
 #include "SimClient/FSClient.h"
+#include "SimVarDef.h"
 #include "Utils/Debug.h"
+#include <cstring>
 
 
 
 namespace FSMfd::SimClient
 {
 
+	struct UnitScale {
+		const char*	unit;
+		uint8_t		quantity;
+		double		perBase;		// amount in this unit per 1 base unit of the quantity
+	};
+
+	constexpr UnitScale UnitScales[] = {
+		{ "knots",				1, 1.0	 },	{ "kilometers per hour",	1, 1.852		 },	{ "miles per hour",	1, 1.150779 },
+		{ "feet",				2, 1.0	 },	{ "ft",						2, 1.0			 },	{ "meters",			2, 0.3048	},
+		{ "feet per minute",	3, 1.0	 },	{ "ft/min",					3, 1.0			 },	{ "meters per minute",	3, 0.3048	},
+		{ "percent",			4, 1.0	 },	{ "percent over 100",		4, 0.01			 },
+		{ "degrees",			5, 1.0	 },	{ "radians",				5, 0.01745329252 },
+		{ "millibar",			6, 1.0	 },	{ "inHg",					6, 0.02952998751 },	{ "kilopascal",		6, 0.1		},
+		{ "psi",				6, 0.01450377377 },
+	};
+
+
+	static const UnitScale* FindUnitScale(const std::string& unit)
+	{
+		for (const UnitScale& us : UnitScales)
+		{
+			if (_stricmp(us.unit, unit.c_str()) == 0)
+				return &us;
+		}
+		return nullptr;
+	}
+
+
 	DedupSimvarRegister::DedupSimvarRegister(FSClient& client) :
 		client { client },
 		Group  { client.CreateVarGroup() }
@@ -38,4 +68,25 @@ namespace FSMfd::SimClient
 	}
 
 
+	optional<double> DedupSimvarRegister::ConversionScale(const SimVarDef& base, const SimVarDef& derived)
+	{
+		if (_stricmp(base.name.c_str(), derived.name.c_str()) != 0 || base.typeReqd != derived.typeReqd)
+			return Nothing;
+
+		if (_stricmp(base.unit.c_str(), derived.unit.c_str()) == 0)
+			return 1.0;
+
+		// integers would need rounding - let SimConnect convert them
+		if (derived.typeReqd != RequestType::Real)
+			return Nothing;
+
+		const UnitScale* from = FindUnitScale(base.unit);
+		const UnitScale* to	  = FindUnitScale(derived.unit);
+		if (from == nullptr || to == nullptr || from->quantity != to->quantity)
+			return Nothing;
+
+		return to->perBase / from->perBase;
+	}
+
+
 }	// namespace FSMfd::SimClient
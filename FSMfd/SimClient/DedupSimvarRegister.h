@@ -20,6 +20,10 @@ namespace FSMfd::SimClient
 		DedupSimvarRegister(FSClient&, GroupId);
 		
 		VarIdx	Add(const SimVarDef&);
+
+		/// Factor to compute @p derived from @p base locally - if they are the same variable,
+		/// in units of the same quantity. Compared like in @a Add: case-insensitively.
+		static optional<double> ConversionScale(const SimVarDef& base, const SimVarDef& derived);
 	};
 
 
@@ -12,16 +12,20 @@
 
 #include <sstream>
 #include <algorithm>
+#include <cmath>
+#include <limits>
 
 
 #define INMOCK_RETURN		if (MockMode)	return
-#define FS_REQUEST(call)	if (!MockMode) { FS_ASSERT(call); }
+#define FS_REQUEST(call)	if (!MockMode && !IsSessionDown()) { FS_ASSERT(call); }
 
 
 namespace FSMfd::SimClient 
 {
 	constexpr char LogSource[] = "FSCLient";
 
+	constexpr DWORD FramesPerDrivenUpdate = 6;		// ~30 FPS / 6 --> 4..5Hz
+
 
 
 #pragma region Connection
@@ -63,7 +67,7 @@ namespace FSMfd::SimClient
 	{
 		INMOCK_RETURN true;
 
-		return hSimConnect != nullptr;
+		return hSimConnect != nullptr || recovery.has_value();
 	}
 
 #pragma endregion
@@ -84,6 +88,9 @@ namespace FSMfd::SimClient
 	FSClient::VarGroup::VarGroup() :
 		varPositions { 0 },
 		dataReceiver { nullptr },
+		frequency	 { UpdateFrequency::PerSecond },
+		priority	 { GroupPriority::Normal },
+		throttle	 { 1 },
 		oneTime		 { false }
 	{
 	}
@@ -97,6 +104,12 @@ namespace FSMfd::SimClient
 	}
 
 
+	bool FSClient::VarGroup::IsPeriodic() const
+	{
+		return dataReceiver != nullptr && !oneTime && frequency != UpdateFrequency::OnValueChange;
+	}
+
+
 	VarIdx FSClient::VarGroup::VarCount() const
 	{
 		DBG_ASSERT (!varPositions.empty());
@@ -111,11 +124,12 @@ namespace FSMfd::SimClient
 	}
 
 
-	void FSClient::VarGroup::Add(SIMCONNECT_DATATYPE typ)
+	void FSClient::VarGroup::Add(const SimVarDef& vardef, SIMCONNECT_DATATYPE typ)
 	{
 		size_t dwords = GetLengthDword(typ);
 
 		varPositions.push_back(varPositions.back() + dwords);
+		definitions.push_back(vardef);
 	}
 
 
@@ -135,7 +149,7 @@ namespace FSMfd::SimClient
 										   vardef.unit.c_str(),
 										   typ				  )
 		);
-		group.Add(typ);
+		group.Add(vardef, typ);
 		return idx;
 	}
 
@@ -216,21 +230,45 @@ namespace FSMfd::SimClient
 
 #pragma region VarGroup Activation
 
-	void FSClient::RequestOnetimeUpdate(GroupId gid, IDataReceiver& receiver)
+	// Nothing: one-time request
+	void FSClient::RequestData(GroupId gid, optional<UpdateFrequency> periodic, unsigned throttle)
 	{
-		VarGroup& group = AccessGroup(gid);
+		DBG_ASSERT (throttle > 0);
 
-		LOGIC_ASSERT_M (group.dataReceiver == nullptr ||
-						group.dataReceiver == &receiver && group.oneTime,
-						"Already have a different subscription!"	    );
+		const auto freq = periodic.value_or(UpdateFrequency::PerSecond);
 
-		DWORD simId = ToSimId(gid);
+		SIMCONNECT_PERIOD update = !periodic.has_value()						   ? SIMCONNECT_PERIOD_ONCE
+								 : (freq == UpdateFrequency::PerSecond ||
+									freq == UpdateFrequency::Sparse)			   ? SIMCONNECT_PERIOD_SECOND
+								 :												 SIMCONNECT_PERIOD_VISUAL_FRAME;
+
+		SIMCONNECT_DATA_REQUEST_FLAG flags = (periodic == UpdateFrequency::OnValueChange) 
+			? SIMCONNECT_DATA_REQUEST_FLAG_CHANGED
+			: 0;
+
+		DWORD skipped = (periodic == UpdateFrequency::FrameDriven) ? FramesPerDrivenUpdate
+					  : (periodic == UpdateFrequency::Sparse)	   ? SparseUpdateRatio - 1
+					  : 0;
+		DWORD interval = (skipped + 1) * throttle - 1;				// periods skipped
+		DWORD simId	   = ToSimId(gid);
 
 		FS_REQUEST (
 			SimConnect_RequestDataOnSimObject(hSimConnect, simId, simId,
 											  SIMCONNECT_OBJECT_ID_USER,
-											  SIMCONNECT_PERIOD_ONCE, 0, 0, 0)
+											  update, flags, 0, interval)
 		);
+	}
+
+
+	void FSClient::RequestOnetimeUpdate(GroupId gid, IDataReceiver& receiver)
+	{
+		VarGroup& group = AccessGroup(gid);
+
+		LOGIC_ASSERT_M (group.dataReceiver == nullptr ||
+						group.dataReceiver == &receiver && group.oneTime,
+						"Already have a different subscription!"	    );
+
+		RequestData(gid, Nothing);
 		group.dataReceiver = &receiver;
 		group.oneTime = true;
 
@@ -239,30 +277,31 @@ namespace FSMfd::SimClient
 	}
 
 
-	void FSClient::EnableVarGroup(GroupId gid, IDataReceiver& reciever, UpdateFrequency freq)
+	void FSClient::EnableVarGroup(GroupId gid, IDataReceiver& reciever, UpdateFrequency freq, GroupPriority prio)
 	{
 		VarGroup& group = AccessGroup(gid);
 
 		LOGIC_ASSERT_M (group.dataReceiver == nullptr, "Already subscribed to group!");
 
-		SIMCONNECT_PERIOD update = (freq == UpdateFrequency::PerSecond)
-			? SIMCONNECT_PERIOD_SECOND
-			: SIMCONNECT_PERIOD_VISUAL_FRAME;
+		group.dataReceiver = &reciever;
+		group.frequency	   = freq;
+		group.priority	   = prio;
+		group.throttle	   = 0;		// requested by Rebalance
+		++subscriptionCount;
 
-		SIMCONNECT_DATA_REQUEST_FLAG flags = (freq == UpdateFrequency::OnValueChange) 
-			? SIMCONNECT_DATA_REQUEST_FLAG_CHANGED
-			: 0;
+		Rebalance();
+	}
 
-		DWORD interval = (freq == UpdateFrequency::FrameDriven) ? 6 : 0;		// ~30 FPS / 6 --> 4..5Hz
-		DWORD	 simId = ToSimId(gid);
 
-		FS_REQUEST (
-			SimConnect_RequestDataOnSimObject(hSimConnect, simId, simId,
-											  SIMCONNECT_OBJECT_ID_USER,
-											  update, flags, 0, interval)
-		);
-		group.dataReceiver = &reciever;
-		++subscriptionCount;
+	void FSClient::SetGroupPriority(GroupId gid, GroupPriority prio)
+	{
+		VarGroup& group = AccessGroup(gid);
+		if (group.priority == prio)
+			return;
+
+		group.priority = prio;
+		if (group.dataReceiver != nullptr && !group.oneTime)
+			Rebalance();
 	}
 
 
@@ -281,6 +320,8 @@ namespace FSMfd::SimClient
 		);
 		group.dataReceiver = nullptr;
 		--subscriptionCount;
+
+		Rebalance();
 	}
 
 
@@ -291,9 +332,13 @@ namespace FSMfd::SimClient
 
 		FS_REQUEST (SimConnect_ClearClientDataDefinition(hSimConnect, simId));
 
-		if (group.dataReceiver != nullptr)
+		const bool wasSubscribed = group.dataReceiver != nullptr;
+		if (wasSubscribed)
 			--subscriptionCount;
 		group = {};
+
+		if (wasSubscribed)
+			Rebalance();
 	}
 
 
@@ -309,19 +354,24 @@ namespace FSMfd::SimClient
 		
 		INMOCK_RETURN *group = {}, true;
 
-		const DWORD simId = ToSimId(gid);
-		if (group->dataReceiver)
+		// session is down: its definitions are gone anyway, only forget the group
+		bool succ = true;
+		if (!IsSessionDown())
 		{
-			HRESULT hr = SimConnect_RequestDataOnSimObject(hSimConnect, simId, simId,
-														   SIMCONNECT_OBJECT_ID_USER,
-														   SIMCONNECT_PERIOD_NEVER  );
-			DBG_ASSERT(SUCCEEDED(hr));
+			const DWORD simId = ToSimId(gid);
+			if (group->dataReceiver)
+			{
+				HRESULT hr = SimConnect_RequestDataOnSimObject(hSimConnect, simId, simId,
+															   SIMCONNECT_OBJECT_ID_USER,
+															   SIMCONNECT_PERIOD_NEVER  );
+				DBG_ASSERT(SUCCEEDED(hr));
+			}
+			HRESULT hr = SimConnect_ClearClientDataDefinition(hSimConnect, simId);
+
+			// Deleting nonexistent probably can yield a FAILURE
+			succ = SUCCEEDED(hr) || group->VarCount() == 0;
+			DBG_ASSERT(succ);
 		}
-		HRESULT hr = SimConnect_ClearClientDataDefinition(hSimConnect, simId);
-		
-		// Deleting nonexistent probably can yield a FAILURE
-		const bool succ = SUCCEEDED(hr) || group->VarCount() == 0;
-		DBG_ASSERT(succ);
 		
 		if (group->dataReceiver != nullptr)
 			--subscriptionCount;
@@ -346,6 +396,89 @@ namespace FSMfd::SimClient
 #pragma endregion
 
 
+
+
+#pragma region Data Budget
+
+	// Rough estimates: actual rates depend on FPS and on how often values change.
+	static double EstimatedPacketsPerSec(UpdateFrequency freq)
+	{
+		constexpr double EstimatedFps = 30.0;
+
+		switch (freq)
+		{
+			case UpdateFrequency::FrameDriven:	return EstimatedFps / FramesPerDrivenUpdate;
+			case UpdateFrequency::Sparse:		return 1.0 / SparseUpdateRatio;
+			default:							return 1.0;
+		}
+	}
+
+
+	void FSClient::SetDataBudget(optional<DataBudget> newBudget)
+	{
+		budget = newBudget;
+		Rebalance();
+	}
+
+
+	// Serves subscribed groups in priority order, throttling lower priorities
+	// by multiplying their periods when the remaining budget is not enough.
+	// Foreground and Critical groups are always requested as specified.
+	void FSClient::Rebalance()
+	{
+		constexpr size_t PacketHeader = sizeof(SIMCONNECT_RECV_SIMOBJECT_DATA) - sizeof(DWORD);
+		constexpr double Unlimited	  = std::numeric_limits<double>::infinity();
+
+		std::vector<pair<GroupId, VarGroup*>> subscribed;
+
+		auto collect = [&subscribed](std::vector<VarGroup>& groups, GroupId firstId)
+		{
+			for (size_t i = 0; i < groups.size(); i++)
+			{
+				if (groups[i].dataReceiver != nullptr && !groups[i].oneTime)
+					subscribed.emplace_back(firstId + Implied<GroupId>(i), &groups[i]);
+			}
+		};
+		collect(varGroupsPermanent, 0);
+		collect(varGroups, MaxPermanentGroups);
+
+		std::stable_sort(subscribed.begin(), subscribed.end(), [](const auto& l, const auto& r)
+		{
+			return l.second->priority > r.second->priority;
+		});
+
+		double bytesLeft   = budget.has_value() ? budget->bytesPerSec	: Unlimited;
+		double packetsLeft = budget.has_value() ? budget->packetsPerSec : Unlimited;
+
+		for (auto [gid, group] : subscribed)
+		{
+			const double packets = EstimatedPacketsPerSec(group->frequency);
+			const double bytes	 = packets * (group->ExpectedBytes() + PacketHeader);
+
+			unsigned throttle = 1;
+			if (group->priority < GroupPriority::Foreground)
+			{
+				const double over = std::max(packets / packetsLeft, bytes / bytesLeft);
+				if (over > 1.0)
+					throttle = over < MaxThrottle ? static_cast<unsigned>(std::ceil(over)) : MaxThrottle;
+			}
+			packetsLeft = std::max(0.0, packetsLeft - packets / throttle);
+			bytesLeft	= std::max(0.0, bytesLeft	- bytes	  / throttle);
+
+			if (group->throttle != throttle)
+			{
+				if (throttle > 1)
+					Debug::Info(LogSource, "Group throttled to fit data budget, period multiplier:", throttle);
+
+				RequestData(gid, group->frequency, throttle);
+				group->throttle = throttle;
+			}
+		}
+	}
+
+#pragma endregion
+
+
 	
 
 #pragma region InFlightDetector - workaround
@@ -434,8 +567,15 @@ namespace FSMfd::SimClient
 		subscriptionCount     { src.subscriptionCount },
 		exhaustedGroupIdCount { src.exhaustedGroupIdCount },
 		inflightDetector	  { std::move(src.inflightDetector) },
+		simConnectVer		  { src.simConnectVer },
+		recovery			  { src.recovery },
+		lastDataReceived	  { src.lastDataReceived },
+		watchdogStats		  { src.watchdogStats },
+		mock				  { src.mock },
+		varGroupsPermanent    (std::move(src.varGroupsPermanent)),
 		varGroups             (std::move(src.varGroups)),
-		eventSubscribers      (std::move(src.eventSubscribers))
+		eventSubscribers      (std::move(src.eventSubscribers)),
+		systemEvents		  (std::move(src.systemEvents))
 	{
 		if (inflightDetector != nullptr)
 			inflightDetector->OwnerMoved(*this);
@@ -507,6 +647,7 @@ namespace FSMfd::SimClient
 			SimConnect_SubscribeToSystemEvent(hSimConnect, nextEventId, name)
 		);
 		uint32_t code = nextEventId++;
+		systemEvents.emplace_back(code, name);
 		eventSubscribers.emplace_back(code, receiver);
 		++subscriptionCount;
 		return code;
@@ -524,9 +665,11 @@ namespace FSMfd::SimClient
 			{
 				if (inflightDetector == nullptr || (*it)->code != inflightDetector->DetectionEvent)
 				{
+					const NotificationCode code = (*it)->code;
 					FS_REQUEST (
-						SimConnect_UnsubscribeFromSystemEvent(hSimConnect, (*it)->code)
+						SimConnect_UnsubscribeFromSystemEvent(hSimConnect, code)
 					);
+					systemEvents.erase(Utils::FindIf(systemEvents, [code](auto& ev) { return ev.first == code; }));
 					--subscriptionCount;
 				}
 				else
@@ -565,6 +708,7 @@ namespace FSMfd::SimClient
 		FSClient&		self;
 		TimePoint		stamp;
 		bool			received = false;		// to signal "correct" nothing without error
+		bool			gotData  = false;		// for the watchdog
 		bool			quit	 = false;		// explicit quit signal received
 		const char*		error    = nullptr;
 		const char*		warning  = nullptr;
@@ -626,6 +770,7 @@ namespace FSMfd::SimClient
 			static_assert(sizeof(uint32_t) == sizeof(DWORD));
 			const uint32_t* data = reinterpret_cast<const uint32_t*>(&objData.dwData);
 		
+			gotData = true;
 			Invoke(&FSClient::PushData, gid, *group, data);
 		}
 
@@ -766,9 +911,14 @@ namespace FSMfd::SimClient
 	{
 		constexpr Duration  Wait          = 2s;
 		constexpr Duration  FirstDataWait = 300ms;
-		static	  TimePoint firstTime = now;
-		static	  TimePoint lastTime  = now;
-		static	  bool		connected = false;
+
+		if (!mock.firstTime.has_value())
+		{
+			mock.firstTime = now;
+			mock.lastTime  = now;
+		}
+		const TimePoint firstTime = *mock.firstTime;
+		TimePoint&		lastTime  = mock.lastTime;
 
 		if (now < lastTime + Wait)
 			return false;
@@ -779,13 +929,13 @@ namespace FSMfd::SimClient
 			simConnectVer = VersionNumber {{1, 1}, {1, 1}};
 			return true;
 		} 
-		if (!connected && firstTime + Wait <= now)
+		if (!mock.connected && firstTime + Wait <= now)
 		{
 			PushEvent(now, inflightDetector->DetectionEvent, 1u);
 			// just guess the first subscriber here...
 			PushStringEvent(now, eventSubscribers[0]->code, "SomeNotMenuAircraft.FLT");
 			lastTime = now + FirstDataWait - Wait;
-			connected = true;
+			mock.connected = true;
 			return true;
 		}
 
@@ -825,14 +975,36 @@ namespace FSMfd::SimClient
 	}
 
 
+	// NTSTATUSes returned by CallDispatch once the pipe to FS is gone
+	static bool IsDisconnection(HRESULT hr)
+	{
+		constexpr HRESULT PipeDisconnected = static_cast<HRESULT>(0xC00000B0);	// named pipe in disconnected state
+		constexpr HRESULT PipeBroken	   = static_cast<HRESULT>(0xC000014B);	// broken pipe
+
+		return hr == PipeDisconnected || hr == HRESULT_FROM_NT(PipeDisconnected)
+			|| hr == PipeBroken		  || hr == HRESULT_FROM_NT(PipeBroken);
+	}
+
+
 	bool FSClient::Receive(TimePoint now)
 	{
 		INMOCK_RETURN MockReceive(now);
 
+		if (IsSessionDown() && !Recover(now))
+			return false;
+
+		if (!AwaitsData())
+		{
+			lastDataReceived = now;		// stall timer starts when data gets due
+		}
+		else if (IsStalled(now))
+		{
+			BeginRecovery(now, false);
+			return false;
+		}
+
 		ReceiveContext context { *this, now };
 
-		// TODO: Disconnect: error = 0xc00000b0 : The specified named pipe is in the disconnected state.
-		//					 error = 0xc000014b : Broken pipe 
 		HRESULT hr = SimConnect_CallDispatch(hSimConnect, &ProcessSimMessage, &context);
 		if (context.warning)
 			Debug::Warning(LogSource, context.warning);
@@ -841,10 +1013,23 @@ namespace FSMfd::SimClient
 			Debug::Warning(LogSource, "SimConnect exception: ", *context.receivedException);
 
 		LOGIC_ASSERT_M (context.error == nullptr, context.error);
+
+		if (IsDisconnection(hr))
+		{
+			BeginRecovery(now, true);
+			return false;
+		}
 		
 		if (!context.quit)
 			FS_ASSERT (hr);
 
+		if (context.gotData)
+		{
+			if (recovery.has_value())
+				FinishRecovery(now);
+			lastDataReceived = now;
+		}
+
 		return !context.quit && context.received;
 	}
 
@@ -860,4 +1045,167 @@ namespace FSMfd::SimClient
 #pragma endregion
 
 
+
+
+#pragma region Watchdog
+
+	auto FSClient::WatchdogStats::MeanTimeToRecover() const -> Duration
+	{
+		return recoveries > 0 ? totalRecover / recoveries : Duration::zero();
+	}
+
+
+	// Periodic groups should deliver at least once per second while in flight.
+	bool FSClient::AwaitsData() const
+	{
+		if (hSimConnect == nullptr)
+			return false;
+
+		if (inflightDetector != nullptr && !inflightDetector->InFlight())
+			return false;
+
+		// throttled groups may stay silent longer
+		auto isDue = [](const VarGroup& g) { return g.IsPeriodic() && g.throttle == 1; };
+
+		return Utils::AnyOf(varGroupsPermanent, isDue) || Utils::AnyOf(varGroups, isDue);
+	}
+
+
+	// A reopened session is given more time until its first data (subscriptions restart).
+	// Stalling again means another reopen, until RecoveryLimit is reached.
+	bool FSClient::IsStalled(TimePoint now) const
+	{
+		const Duration limit = recovery.has_value() ? ReopenedStallLimit : StallLimit;
+
+		return AwaitsData() && lastDataReceived + limit < now;
+	}
+
+
+	void FSClient::BeginRecovery(TimePoint now, bool pipeError)
+	{
+		if (pipeError)
+			++watchdogStats.pipeErrors;
+		else
+			++watchdogStats.stalls;
+
+		Debug::Warning(LogSource, pipeError ? "Connection lost, reopening session." 
+											: "Data stalled, reopening session."	);
+
+		if (!recovery.has_value())
+		{
+			watchdogStats.totalDetect += now - lastDataReceived;
+			recovery = Recovery { now, TimePoint::min() };
+		}
+		recovery->reopened = false;
+
+		if (hSimConnect != nullptr)
+			SimConnect_Close(hSimConnect);		// result does not matter, pipe is gone anyway
+		hSimConnect = nullptr;
+		simConnectVer.reset();
+	}
+
+
+	// @returns session reopened
+	bool FSClient::Recover(TimePoint now)
+	{
+		DBG_ASSERT (IsSessionDown());
+
+		if (now < recovery->lastAttempt + ReopenInterval)
+			return false;
+
+		if (recovery->detected + RecoveryLimit < now)
+		{
+			recovery.reset();
+			throw SimConnectError { E_FAIL, "Could not recover SimConnect session." };
+		}
+
+		recovery->lastAttempt = now;
+		if (!TryReopen())
+			return false;
+
+		lastDataReceived = now;		// stall timer restarts for the new session
+
+		Debug::Info(LogSource, "Session reopened, subscriptions restored.");
+		return true;
+	}
+
+
+	void FSClient::FinishRecovery(TimePoint now)
+	{
+		const Duration took = now - recovery->detected;
+		recovery.reset();
+
+		++watchdogStats.recoveries;
+		watchdogStats.totalRecover += took;
+
+		auto ms	  = std::chrono::duration_cast<std::chrono::milliseconds>(took);
+		auto mttr = std::chrono::duration_cast<std::chrono::milliseconds>(watchdogStats.MeanTimeToRecover());
+		Debug::Info(LogSource, "Recovered session [ms]:", Practically<int>(ms.count()));
+		Debug::Info(LogSource, "Mean time to recover [ms]:", Practically<int>(mttr.count()));
+	}
+
+
+	bool FSClient::TryReopen()
+	{
+		DBG_ASSERT (hSimConnect == nullptr);
+
+		HRESULT hr = SimConnect_Open(&hSimConnect, ClientAppName, nullptr,
+									 0, 0, SIMCONNECT_OPEN_CONFIGINDEX_LOCAL);
+		if (FAILED(hr))
+		{
+			hSimConnect = nullptr;
+			return false;
+		}
+
+		try
+		{
+			recovery->reopened = true;		// let FS_REQUESTs through
+			RestoreSubscriptions();
+		}
+		catch (...)
+		{
+			recovery->reopened = false;
+			SimConnect_Close(hSimConnect);
+			hSimConnect = nullptr;
+			return false;
+		}
+		return true;
+	}
+
+
+	// Definitions and requests are kept by SimConnect per session only - replay everything known.
+	void FSClient::RestoreSubscriptions()
+	{
+		auto restoreGroup = [this](GroupId gid, const VarGroup& group)
+		{
+			if (group.IsEmpty())
+				return;
+
+			for (const SimVarDef& vardef : group.definitions)
+			{
+				FS_REQUEST (
+					SimConnect_AddToDataDefinition(hSimConnect,
+												   ToSimId(gid),
+												   vardef.name.c_str(),
+												   vardef.unit.c_str(),
+												   TypeMapping[AsIndex(vardef.typeReqd)])
+				);
+			}
+			if (group.dataReceiver != nullptr)
+				RequestData(gid, group.oneTime ? Nothing : optional { group.frequency }, group.throttle);
+		};
+
+		for (GroupId gid = 0; gid < varGroupsPermanent.size(); gid++)
+			restoreGroup(gid, varGroupsPermanent[gid]);
+
+		for (GroupId i = 0; i < varGroups.size(); i++)
+			restoreGroup(i + MaxPermanentGroups, varGroups[i]);
+
+		for (const auto& [code, name] : systemEvents)
+			FS_REQUEST (SimConnect_SubscribeToSystemEvent(hSimConnect, code, name.c_str()));
+	}
+
+#pragma endregion
+
+
 }	// namespace FSMfd
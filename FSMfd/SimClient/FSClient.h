@@ -34,8 +34,8 @@ namespace FSMfd::SimClient
 	/// @remarks
 	///	  Each communicating method throws SimConnectError on FAILURE.
 	///	  In such case it's best to discard this whole object and reconnect.
-	///	  (Error codes could be checked for NTSTATUSes denoting disconnection
-	///	   [STATUS_REMOTE_DISCONNECT, ...?], not being done currently.)
+	///	  Exception is a broken pipe or stalled data noticed during Receive:
+	///	  a watchdog reopens the session then, restoring every subscription.
 	class FSClient {
 
 		void*					hSimConnect;
@@ -45,13 +45,18 @@ namespace FSMfd::SimClient
 		// Each group represents a SimConnect DataDefinition, as well as a DataRequest.
 		struct VarGroup {
 			std::vector<size_t>		varPositions;	// last denotes end of data buffer
+			std::vector<SimVarDef>	definitions;	// to restore after reconnection
 			IDataReceiver*			dataReceiver;
+			UpdateFrequency			frequency;		// if subscribed (not oneTime)
+			GroupPriority			priority;
+			unsigned				throttle;		// period multiplier to fit budget, 0: not requested yet
 			bool					oneTime;
 
 			bool	IsEmpty()		const;
+			bool	IsPeriodic()	const;
 			VarIdx	VarCount()		const;
 			size_t	ExpectedBytes() const;
-			void	Add(SIMCONNECT_DATATYPE);
+			void	Add(const SimVarDef&, SIMCONNECT_DATATYPE);
 			VarGroup();
 			VarGroup(VarGroup&&)				 = default;
 			VarGroup& operator=(VarGroup&&)		 = default;
@@ -60,6 +65,7 @@ namespace FSMfd::SimClient
 		std::vector<VarGroup>	varGroupsPermanent;
 		std::vector<VarGroup>	varGroups;
 		GroupId					exhaustedGroupIdCount = 0;
+		optional<DataBudget>	budget;
 
 
 		// FS System events
@@ -68,6 +74,7 @@ namespace FSMfd::SimClient
 			IEventReceiver&		subscriber;
 		};
 		std::vector<Utils::Reassignable<EventSubscriber>>	eventSubscribers;
+		std::vector<pair<NotificationCode, std::string>>	systemEvents;		// subscribed at SimConnect
 		
 		NotificationCode nextEventId	   = 1;					
 		size_t			 subscriptionCount = 0;
@@ -77,11 +84,56 @@ namespace FSMfd::SimClient
 		class InFlightDetector;
 		std::unique_ptr<InFlightDetector>	inflightDetector;
 
+
+		// Receive watchdog
+		struct Recovery {
+			TimePoint	detected;
+			TimePoint	lastAttempt;
+			bool		reopened = false;
+		};
+		optional<Recovery>	recovery;
+		TimePoint			lastDataReceived;		// or since when it's due
+
+
+		// simulated connection progress in MockMode (timed by the stamps received)
+		struct MockState {
+			optional<TimePoint>	firstTime;
+			TimePoint			lastTime;
+			bool				connected = false;
+		};
+		MockState	mock;
+
 	public:
 		/// Pages Debug: set to run without Sim
 		static constexpr bool MockMode = false;
 
 
+		struct WatchdogStats {
+			unsigned	pipeErrors	  = 0;
+			unsigned	stalls		  = 0;
+			unsigned	recoveries	  = 0;
+			Duration	totalDetect	  = Duration::zero();	// last data -> problem noticed
+			Duration	totalRecover  = Duration::zero();	// problem noticed -> data flows again
+
+			Duration	MeanTimeToRecover() const;
+		};
+
+	private:
+		WatchdogStats	watchdogStats;
+
+	public:
+		/// Periodic data missing this long while in flight is considered a stall.
+		Duration	StallLimit		   = 10s;
+		/// A reopened session stalling this long before its first data is reopened again.
+		Duration	ReopenedStallLimit = 20s;
+		Duration	ReopenInterval	   = 2s;
+		/// Unsuccessful recovery throws SimConnectError after this.
+		Duration	RecoveryLimit	   = 60s;
+
+		/// Lower priority groups get at most this much longer periods to fit the DataBudget.
+		static constexpr unsigned MaxThrottle = 10;
+
+
 		// ----- Fields + special -------------------------------------------------------
 
 		const char* const	ClientAppName;
@@ -106,7 +158,12 @@ namespace FSMfd::SimClient
 		void RequestOnetimeUpdate(GroupId, IDataReceiver&);
 
 		/// Register receiver for notifications about the given variable group.
-		void EnableVarGroup(GroupId, IDataReceiver&, UpdateFrequency = UpdateFrequency::PerSecond);
+		/// @remarks	Below Foreground priority the frequency may be reduced to fit the DataBudget.
+		void EnableVarGroup(GroupId, IDataReceiver&,
+							UpdateFrequency = UpdateFrequency::PerSecond,
+							GroupPriority	= GroupPriority::Normal		 );
+
+		void SetGroupPriority(GroupId, GroupPriority);
 
 		/// Disable notifications about variable group and unregister its receiver.
 		void DisableVarGroup(GroupId);
@@ -121,6 +178,9 @@ namespace FSMfd::SimClient
 
 		void ResetVarGroups();
 
+		/// Nothing: unlimited.
+		void SetDataBudget(optional<DataBudget>);
+
 		
 		// ----- Events -----------------------------------------------------------------
 
@@ -136,7 +196,12 @@ namespace FSMfd::SimClient
 		// ----- Connect + Run ----------------------------------------------------------
 
 		bool TryConnect();
+
+		/// Stays true while the watchdog is recovering the session.
 		bool IsConnected() const;
+		bool IsRecovering() const	{ return recovery.has_value(); }
+
+		const WatchdogStats& GetWatchdogStats() const	{ return watchdogStats; }
 
 		/// SimConnect version as received after opening connection.
 		optional<VersionNumber> SimconnectVersion() const	{ return simConnectVer; }
@@ -161,10 +226,21 @@ namespace FSMfd::SimClient
 
 	private:
 		void PushData(TimePoint, GroupId, VarGroup&, const uint32_t* data);
+		void RequestData(GroupId, optional<UpdateFrequency> periodic, unsigned throttle = 1);
+		void Rebalance();
 		void PushEvent(TimePoint, NotificationCode, uint32_t parameter);
 		void PushStringEvent(TimePoint, NotificationCode, const char* path);
 
 		bool MockReceive(TimePoint);
+
+		bool IsSessionDown()		const	{ return recovery.has_value() && !recovery->reopened; }
+		bool AwaitsData()			const;
+		bool IsStalled(TimePoint)	const;
+		void BeginRecovery(TimePoint, bool pipeError);
+		bool Recover(TimePoint);
+		void FinishRecovery(TimePoint);
+		bool TryReopen();
+		void RestoreSubscriptions();
 		
 		uint32_t	ToSimId(GroupId gid)		const noexcept;
 		GroupId		ToGroupId(uint32_t simId)	const noexcept;
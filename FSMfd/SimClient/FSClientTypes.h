@@ -28,7 +28,26 @@ namespace FSMfd::SimClient
 	enum class UpdateFrequency { 
 		PerSecond,
 		FrameDriven,			// estimate 5 Hz using a fixed ratio to FPS
-		OnValueChange
+		OnValueChange,
+		Sparse					// every SparseUpdateRatio seconds, for slowly changing values
+	};
+
+	constexpr unsigned SparseUpdateRatio = 3;
+
+
+	/// Order in which groups keep their requested frequency under a DataBudget.
+	enum class GroupPriority {
+		Background,				// e.g. prewarmed pages - throttled first
+		Normal,
+		Foreground,				// active page	- never throttled
+		Critical				// warning LEDs	- never throttled
+	};
+
+
+	/// Bound of the continuous traffic caused by periodic subscriptions.
+	struct DataBudget {
+		unsigned bytesPerSec;
+		unsigned packetsPerSec;
 	};
 
 
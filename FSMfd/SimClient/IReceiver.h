@@ -41,6 +41,9 @@ namespace FSMfd::SimClient
 		VarIdx VarCount()	const	{ return varCount; }
 		size_t DataDWords()	const	{ return positions[varCount]; }
 
+		/// Values of all variables back to back, @a DataDWords long.
+		const uint32_t* RawData()	const	{ return data; }
+
 		SimvarValue operator[](VarIdx) const;
 
 		/// Quickly save received variables for potential later use.
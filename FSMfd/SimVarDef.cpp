@@ -7,6 +7,14 @@ namespace FSMfd
 	using Utils::String::AsDumbWString;
 
 
+	bool SimVarDef::operator==(const SimVarDef& rhs)
+	{
+		return _stricmp(name.c_str(), rhs.name.c_str()) == 0
+			&& _stricmp(unit.c_str(), rhs.unit.c_str()) == 0
+			&& typeReqd == rhs.typeReqd;
+	}
+
+
 	static std::wstring DefaultUnitText(const SimVarDef& def)
 	{
 		const char* name = def.unit.c_str();
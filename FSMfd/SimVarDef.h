@@ -21,6 +21,14 @@ namespace FSMfd
 
 
 
+	/// Whether a SimPage may estimate values between updates.
+	enum class Smoothing : uint8_t {
+		Auto,		// by unit: continuous quantities
+		Off			// changes in steps, e.g. trims or flaps set by input
+	};
+
+
+
 	/// Description of a queriable simulation variable.
 	/// @remarks 
 	///		Technically independent for Page configs,
@@ -28,8 +36,10 @@ namespace FSMfd
 	struct SimVarDef {
 		std::string		name;
 		std::string		unit;
-		RequestType		typeReqd = RequestType::UnsignedInt;
+		RequestType		typeReqd  = RequestType::UnsignedInt;
+		Smoothing		smoothing = Smoothing::Auto;	// presentation hint, not part of the request
 
+		/// Same request - names and units are case-insensitive for SimConnect.
 		bool operator==(const SimVarDef& rhs);
 		bool operator!=(const SimVarDef& rhs)	{ return !operator==(rhs); }
 	};
@@ -60,15 +70,4 @@ namespace FSMfd
 	};
 
 
-	
-	// ----------------------------------------------------------------------------------
-
-	inline bool SimVarDef::operator==(const SimVarDef& rhs)
-	{
-		return name == rhs.name
-			&& unit == rhs.unit
-			&& typeReqd == rhs.typeReqd;
-	}
-
-
 }	// namespace FSMfd
@@ -1,7 +1,14 @@
 #include "LiteSharedLock.h"
 #include "Debug.h"
+#include <functional>
 #include <thread>
 
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+
+#pragma comment(lib, "Synchronization.lib")		// WaitOnAddress
+
 
 
 namespace Utils
@@ -10,7 +17,49 @@ namespace Utils
 	static constexpr int MaxSpinsExclusives			 = 100;
 	static constexpr int MaxSpinsExclusiveForShareds = 2000;
 
-//	void Test() { ; }
+
+#pragma region Parking
+
+	/// Spin a little, then sleep on @p word until @p blocks isn't true for its value.
+	/// @param parked:	announces sleeping to waking side
+	template <class T, class P>
+	static void Await(std::atomic<T>& word, std::atomic_int& parked, int maxSpins, P&& blocks) noexcept
+	{
+		T value = word.load();
+		for (int s = 0; blocks(value) && s < maxSpins; ++s)
+		{
+			YieldProcessor();
+			value = word.load();
+		}
+
+		while (blocks(value))
+		{
+			++parked;
+
+			// recheck after announcing - pairs with Wake
+			value = word.load();
+			if (blocks(value))
+				WaitOnAddress(&word, &value, sizeof(T), INFINITE);
+
+			--parked;
+			value = word.load();
+		}
+	}
+
+
+	/// Call after changing @p word.
+	template <class T>
+	static void Wake(std::atomic<T>& word, const std::atomic_int& parked) noexcept
+	{
+		if (parked.load() > 0)
+			WakeByAddressAll(&word);
+	}
+
+#pragma endregion
+
+
+
+#pragma region LiteSharedLock
 
 	void LiteSharedLock::LockShared() noexcept
 	{
@@ -23,8 +72,7 @@ namespace Utils
 
 			// below 0 a writer awaits, shared "readers" should cool down
 			DBG_ASSERT (exclusiveAwaits);
-			--shareCount;
-			std::this_thread::yield();
+			LeaveShared();
 
 			// wait for the write to finish, then retry
 			WaitExclusiveFin();
@@ -34,7 +82,15 @@ namespace Utils
 
 	void LiteSharedLock::UnlockShared() noexcept
 	{
-		--shareCount;
+		LeaveShared();
+	}
+
+
+	// The last one to leave lets the awaiting writer in.
+	void LiteSharedLock::LeaveShared() noexcept
+	{
+		if (--shareCount == MinInt)
+			Wake(shareCount, parked);
 	}
 
 
@@ -57,17 +113,9 @@ namespace Utils
 		DBG_ASSERT (ticket < 0);
 
 		// 3. active readers are free to finish, wait them
-		do
-		{
-			// New read trials can anytime disturb the ticket,
-			// but once MinInt was reached, we know that all
-			// readers are just attempting to lock.
-			for (int s = 0; ticket > MinInt && s < MaxSpinsExclusiveForShareds; ++s)
-				ticket = shareCount;
-
-			std::this_thread::yield();
-		}
-		while (ticket > MinInt);
+		//	  New read trials can anytime disturb the ticket, but once MinInt
+		//	  was reached, we know that all readers are just attempting to lock.
+		Await(shareCount, parked, MaxSpinsExclusiveForShareds, [](int t) { return t > MinInt; });
 	}
 
 
@@ -77,7 +125,7 @@ namespace Utils
 		if (ticket > 0)
 			return true;
 
-		--shareCount;
+		LeaveShared();
 		return false;
 	}
 
@@ -87,26 +135,103 @@ namespace Utils
 		DBG_ASSERT (shareCount < 0 && exclusiveAwaits);
 		shareCount += MinInt;
 		exclusiveAwaits = false;
+		Wake(exclusiveAwaits, parked);
 	}
 
 
 	void LiteSharedLock::WaitExclusiveFin() noexcept
 	{
-		bool occup = exclusiveAwaits;
-		while (occup)
+		Await(exclusiveAwaits, parked, MaxSpinsShared, [](bool occup) { return occup; });
+	}
+
+
+	LiteSharedLock::~LiteSharedLock()
+	{
+		DBG_ASSERT (shareCount == 0);
+	}
+
+#pragma endregion
+
+
+
+#pragma region DistributedSharedLock
+
+	size_t DistributedSharedLock::ThreadSlot() noexcept
+	{
+		static thread_local const size_t slot = std::hash<std::thread::id> {}(std::this_thread::get_id()) % SlotCount;
+		return slot;
+	}
+
+
+	void DistributedSharedLock::LockShared() noexcept
+	{
+		Slot& slot = slots[ThreadSlot()];
+		while (true)
 		{
-			for (int s = 0; occup && s < MaxSpinsShared; ++s)
-				occup = exclusiveAwaits;
+			// seq_cst pairs with LockExclusive: either we see its flag, or it sees our count
+			++slot.readers;
+			if (!exclusive)
+				return;
 
-			if (occup)
-				std::this_thread::yield();
+			LeaveSlot(slot);
+			Await(exclusive, parked, MaxSpinsShared, [](bool occup) { return occup; });
 		}
 	}
 
 
-	LiteSharedLock::~LiteSharedLock()
+	bool DistributedSharedLock::TryLockShared() noexcept
 	{
-		DBG_ASSERT (shareCount == 0);
+		Slot& slot = slots[ThreadSlot()];
+
+		++slot.readers;
+		if (!exclusive)
+			return true;
+
+		LeaveSlot(slot);
+		return false;
+	}
+
+
+	void DistributedSharedLock::UnlockShared() noexcept
+	{
+		LeaveSlot(slots[ThreadSlot()]);
+	}
+
+
+	void DistributedSharedLock::LeaveSlot(Slot& slot) noexcept
+	{
+		if (--slot.readers == 0)
+			Wake(slot.readers, parked);
+	}
+
+
+	void DistributedSharedLock::LockExclusive() noexcept
+	{
+		bool expect = false;
+		while (!exclusive.compare_exchange_strong(expect, true))
+		{
+			expect = false;
+			Await(exclusive, parked, MaxSpinsExclusives, [](bool occup) { return occup; });
+		}
+
+		for (Slot& slot : slots)
+			Await(slot.readers, parked, MaxSpinsExclusiveForShareds, [](int r) { return r > 0; });
 	}
 
-}	// namespace Utils
\ No newline at end of file
+
+	void DistributedSharedLock::UnlockExclusive() noexcept
+	{
+		DBG_ASSERT (exclusive);
+		exclusive = false;
+		Wake(exclusive, parked);
+	}
+
+
+	DistributedSharedLock::~DistributedSharedLock()
+	{
+		DBG_ASSERT (!exclusive);
+	}
+
+#pragma endregion
+
+}	// namespace Utils
@@ -6,6 +6,7 @@
 	 *  Released under GPLv3.		   */
 
 
+#include <array>
 #include <atomic>
 #include <limits>
 
@@ -15,9 +16,13 @@ namespace Utils
 {
 
 	/// Fully optimistic for reads, assuming writes are occasional.
+	/// @remarks
+	///	  Waiting spins briefly, then parks the thread on the lock word (WaitOnAddress),
+	///	  so contention doesn't burn CPU. Unlocking only wakes if any thread is parked.
 	class LiteSharedLock {
 		std::atomic_int		 shareCount		 = 0;		// < 0 during exclusive lock!
 		std::atomic_bool	 exclusiveAwaits = false;
+		std::atomic_int		 parked			 = 0;		// sleeping on either of the above
 		
 		static constexpr int MinInt = std::numeric_limits<int>::min();
 
@@ -48,6 +53,51 @@ namespace Utils
 
 	private:
 		void WaitExclusiveFin() noexcept;
+		void LeaveShared()		noexcept;
 	};
 
-}
\ No newline at end of file
+
+
+	/// Reader-scalable variant of LiteSharedLock: readers count on separate cache lines.
+	/// @remarks
+	///	  Concurrent readers don't contend on a single counter, for the price of exclusive
+	///	  locking scanning every slot - and 1 KiB size. Slots are assigned per thread rather
+	///	  than per core, as a thread may migrate between locking and unlocking.
+	class DistributedSharedLock {
+	public:
+		static constexpr size_t SlotCount = 16;
+
+	private:
+		struct alignas(64) Slot {
+			std::atomic_int	readers = 0;
+		};
+		std::array<Slot, SlotCount>		slots;
+		alignas(64) std::atomic_bool	exclusive = false;
+		std::atomic_int					parked	  = 0;
+
+		static size_t ThreadSlot() noexcept;
+
+	public:
+		void LockShared()		noexcept;
+		void LockExclusive()	noexcept;
+		bool TryLockShared()	noexcept;
+
+		void UnlockShared()		noexcept;
+		void UnlockExclusive()	noexcept;
+
+
+		// STL compatibility (Shared- & BasicLockable)
+		void lock_shared()		noexcept	{ LockShared();			  }
+		void lock()				noexcept	{ LockExclusive();		  }
+		void unlock_shared()	noexcept	{ UnlockShared();		  }
+		void unlock()			noexcept	{ UnlockExclusive();	  }
+		bool try_lock_shared()	noexcept	{ return TryLockShared(); }
+
+
+		~DistributedSharedLock();
+
+	private:
+		void LeaveSlot(Slot&)	noexcept;
+	};
+
+}
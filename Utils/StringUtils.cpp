@@ -4,7 +4,9 @@
 #include "CastUtils.h"
 #include "Debug.h"
 
-#include <cfenv>
+#include <algorithm>
+#include <cmath>
+#include <iterator>
 #include <locale>
 #include <utility>
 
@@ -54,12 +56,19 @@ namespace Utils::String
 
 #pragma region StringSection
 
+	StringSection::StringSection(wchar_t* buffer, size_t bufferLength, size_t pos, size_t length) :
+		buffer		 { buffer },
+		bufferLength { bufferLength },
+		Pos			 { pos },
+		Length		 { length }
+	{
+		LOGIC_ASSERT (pos + length <= bufferLength);
+	}
+
+
 	StringSection::StringSection(std::wstring& buffer, size_t pos, size_t length) :
-		buffer	{ buffer },
-		Pos		{ pos },
-		Length	{ length }
+		StringSection { buffer.data(), buffer.length(), pos, length }		// wstring excludes \0
 	{
-		LOGIC_ASSERT (pos + length <= buffer.length());		// wstring excludes \0
 	}
 
 
@@ -71,7 +80,7 @@ namespace Utils::String
 
 	StringSection StringSection::FollowedBy(size_t nextLength) const
 	{
-		return { buffer, Pos + Length, nextLength };
+		return { buffer, bufferLength, Pos + Length, nextLength };
 	}
 
 
@@ -79,7 +88,7 @@ namespace Utils::String
 	{
 		LOGIC_ASSERT (offset + length <= this->Length);
 
-		return { buffer, Pos + offset, length };
+		return { buffer, bufferLength, Pos + offset, length };
 	}
 
 	
@@ -92,7 +101,7 @@ namespace Utils::String
 
 	wchar_t* StringSection::GetStart() const
 	{
-		return buffer.data() + Pos;
+		return buffer + Pos;
 	}
 
 
@@ -111,8 +120,7 @@ namespace Utils::String
 
 	void StringSection::FillIn(std::wstring_view src)
 	{
-		DBG_ASSERT	   (src.length() == Length);
-		LOGIC_ASSERT_M (buffer.size() >= Pos + Length, "Buffer shortened in meantime?")
+		DBG_ASSERT (src.length() == Length);
 
 		wchar_t* trg = GetStart();
 		for (size_t i = 0; i < src.length(); i++)
@@ -133,12 +141,30 @@ namespace Utils::String
 
 #pragma region CoreHelpers
 
-	// Calls the non-throwing swprintf.
-	// The templated swprintf_s throws if buffer is too small.
-	template <size_t S, class... Args>
-	int PrintTo(wchar_t (&buff)[S], const wchar_t* format, const Args&... args)
+	// Writes the decimal digits of @p value backwards, ending before @p end.
+	// @returns	First written character.
+	static wchar_t* WriteDigitsBefore(wchar_t* end, uint64_t value)
+	{
+		do
+		{
+			*--end = static_cast<wchar_t>(L'0' + value % 10);
+			value /= 10;
+		}
+		while (value != 0);
+
+		return end;
+	}
+
+
+	// Writes exactly @p count digits of @p value backwards (keeping leading zeros), ending before @p end.
+	static wchar_t* WriteFixedDigitsBefore(wchar_t* end, uint64_t value, unsigned count)
 	{
-		return swprintf(buff, S, format, args...);
+		for (unsigned i = 0; i < count; i++)
+		{
+			*--end = static_cast<wchar_t>(L'0' + value % 10);
+			value /= 10;
+		}
+		return end;
 	}
 
 #pragma endregion
@@ -176,7 +202,8 @@ namespace Utils::String
 	}
 
 
-	static size_t FillTarget(const std::wstring_view& src, size_t off, size_t maxCount, StringSection target)
+	template <class Ch>
+	static size_t FillTarget(const std::basic_string_view<Ch>& src, size_t off, size_t maxCount, StringSection target)
 	{
 		DBG_ASSERT (off + maxCount <= target.Length);	// expects checked parameters
 
@@ -185,7 +212,9 @@ namespace Utils::String
 		for (size_t i = 0; i < off; i++)
 			trg[i] = Space;
 
-		const size_t written = src.copy(trg + off, maxCount);
+		const size_t written = std::min(maxCount, src.length());
+		for (size_t i = 0; i < written; i++)
+			trg[off + i] = src[i];
 
 		for (size_t i = off + written; i < target.Length; i++)
 			trg[i] = Space;
@@ -194,7 +223,8 @@ namespace Utils::String
 	}
 
 
-	static size_t FillTarget(const std::wstring_view& src, size_t off, StringSection target)
+	template <class Ch>
+	static size_t FillTarget(const std::basic_string_view<Ch>& src, size_t off, StringSection target)
 	{
 		return FillTarget(src, off, src.length(), target);
 	}
@@ -207,7 +237,8 @@ namespace Utils::String
 	}
 
 
-	bool PlaceText(std::wstring_view src, StringSection target, PaddedAlignment aln)
+	template <class Ch>
+	static bool PlaceAnyText(const std::basic_string_view<Ch>& src, StringSection target, const PaddedAlignment& aln)
 	{
 		if (target.Length < src.length())
 			return false;
@@ -223,7 +254,8 @@ namespace Utils::String
 
 
 	// padding takes precedence here
-	size_t PlaceTruncableText(std::wstring_view src, StringSection target, PaddedAlignment aln)
+	template <class Ch>
+	static size_t PlaceAnyTruncableText(const std::basic_string_view<Ch>& src, StringSection target, const PaddedAlignment& aln)
 	{
 		DBG_ASSERT_M (aln.pad < target.Length, "Unintended padding parameter?");		// should run fine though
 
@@ -233,6 +265,30 @@ namespace Utils::String
 	}
 
 
+	bool PlaceText(std::wstring_view src, StringSection target, PaddedAlignment aln)
+	{
+		return PlaceAnyText(src, target, aln);
+	}
+
+
+	bool PlaceText(std::string_view src, StringSection target, PaddedAlignment aln)
+	{
+		return PlaceAnyText(src, target, aln);
+	}
+
+
+	size_t PlaceTruncableText(std::wstring_view src, StringSection target, PaddedAlignment aln)
+	{
+		return PlaceAnyTruncableText(src, target, aln);
+	}
+
+
+	size_t PlaceTruncableText(std::string_view src, StringSection target, PaddedAlignment aln)
+	{
+		return PlaceAnyTruncableText(src, target, aln);
+	}
+
+
 	std::wstring AlignCenter(size_t lineLen, std::wstring_view src)
 	{
 		LOGIC_ASSERT (src.length() <= lineLen);
@@ -251,13 +307,13 @@ namespace Utils::String
 
 #pragma region PlaceNumber
 
-	static bool AlignIntegerChars(const wchar_t* digits, int printed, StringSection target, const PaddedAlignment& aln, const std::wstring_view& overrunSymb)
+	static bool AlignIntegerChars(const wchar_t* digits, size_t printed, StringSection target, const PaddedAlignment& aln, const std::wstring_view& overrunSymb)
 	{
 		LOGIC_ASSERT (printed > 0);
 
 		if (printed <= target.Length)
 		{
-			AlignText({ digits, Cast::Implied<unsigned>(printed) }, aln, target);
+			AlignText({ digits, printed }, aln, target);
 			return true;
 		}
 		PlaceTruncableText(overrunSymb, target, aln);
@@ -267,10 +323,11 @@ namespace Utils::String
 
 	bool PlaceNumber(uint32_t value, StringSection target, PaddedAlignment aln, std::wstring_view overrunSymb)
 	{
-		wchar_t num[Int32MaxChars + 1];
-		int		len = PrintTo(num, L"%u", value);
+		wchar_t				 num[Int32MaxChars];
+		wchar_t* const		 end   = num + Int32MaxChars;
+		const wchar_t* const start = WriteDigitsBefore(end, value);
 
-		return AlignIntegerChars(num, len, target, aln, overrunSymb);
+		return AlignIntegerChars(start, Cast::Implied<size_t>(end - start), target, aln, overrunSymb);
 	}
 
 
@@ -282,14 +339,18 @@ namespace Utils::String
 			return false;
 		};
 
-		const wchar_t* format = NonDefault(sign & SignUsage::PrependPlus) && value != 0
-			? L"%+d" 
-			: L"%d";
+		// mind INT_MIN
+		const uint32_t magnitude = value < 0 ? 0u - static_cast<uint32_t>(value) : static_cast<uint32_t>(value);
 
-		wchar_t num[Int32MaxChars + 1];
-		int		len = PrintTo(num, format, value);
+		wchar_t			num[Int32MaxChars];
+		wchar_t* const	end	  = num + Int32MaxChars;
+		wchar_t*		start = WriteDigitsBefore(end, magnitude);
+		if (value < 0)
+			*--start = L'-';
+		else if (NonDefault(sign & SignUsage::PrependPlus) && value != 0)
+			*--start = L'+';
 
-		return AlignIntegerChars(num, len, target, aln, overrunSymb);
+		return AlignIntegerChars(start, Cast::Implied<size_t>(end - start), target, aln, overrunSymb);
 	}
 
 
@@ -301,14 +362,13 @@ namespace Utils::String
 
 
 
-	static bool TryAlignDecimal(const std::wstring_view& num, StringSection target, const PaddedAlignment& aln, bool preferDecimals)
+	/// @param wholePart:	length of @p num before the decimal separator (if any)
+	static bool TryAlignDecimal(const std::wstring_view& num, size_t wholePart, StringSection target, const PaddedAlignment& aln, bool preferDecimals)
 	{
 		LOGIC_ASSERT (aln.pad < target.Length);
 		DBG_ASSERT	 (0 < num.length());
 
-		const size_t pointPos  = num.find(DecimalSeparator);
-		const bool	 hasPoint  = pointPos != num.npos;
-		const size_t wholePart = hasPoint ? pointPos : num.length();
+		const bool	 hasPoint  = wholePart < num.length();
 		if (target.Length < wholePart)
 			return false;
 
@@ -326,6 +386,57 @@ namespace Utils::String
 	}
 
 
+	/// Fixed-point digits of @p value, truncated to @p decimals.
+	/// @returns	Length of the whole part (with sign), 0 if not representable within PlaceDoubleMaxChars.
+	static size_t FormatTruncated(double value, unsigned decimals, SignUsage sign, wchar_t* const end, wchar_t*& start)
+	{
+		static constexpr double Pow10s[] = {
+			1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15
+		};
+		static_assert (std::size(Pow10s) == MaxFractionDigits + 1);
+
+		// beyond this the length check below would fail anyway
+		const double magnitude = std::fabs(value);
+		if (!(magnitude < Utils::Pow10<MaxWholeDigits + 1>::value))		// also NaN
+			return 0;
+
+		const double whole = std::trunc(magnitude);			// exact
+
+		// Truncate digits of the value as written - a scaled fraction within an ulp of @p value
+		// to the next integer counts as reaching it (e.g. 0.29 -> 29, although 0.29 is 0.28999...).
+		// Never carry into the whole part though.
+		const uint64_t unit		= static_cast<uint64_t>(Pow10s[decimals]);
+		const double   scaled	= (magnitude - whole) * Pow10s[decimals];
+		const double   slack	= (std::nextafter(magnitude, HUGE_VAL) - magnitude) * Pow10s[decimals];
+		uint64_t	   fraction = static_cast<uint64_t>(scaled);
+		if (static_cast<double>(fraction + 1) - scaled <= slack)
+			++fraction;
+		if (fraction >= unit)
+			fraction = unit - 1;
+
+		wchar_t* p = end;
+		if (decimals > 0)
+		{
+			p	 = WriteFixedDigitsBefore(p, fraction, decimals);
+			*--p = DecimalSeparator;
+		}
+		wchar_t* const point = p;
+
+		p = WriteDigitsBefore(p, static_cast<uint64_t>(whole));
+		const bool zero = whole == 0 && fraction == 0;
+		if (std::signbit(value) && !(zero && NonDefault(sign & SignUsage::AvoidNegativeZero)))
+			*--p = L'-';
+		else if (NonDefault(sign & SignUsage::PrependPlus))
+			*--p = L'+';
+
+		if (Cast::Implied<size_t>(end - p) > PlaceDoubleMaxChars)
+			return 0;
+
+		start = p;
+		return Cast::Implied<size_t>(point - p);
+	}
+
+
 	bool PlaceNumber(double value, DecimalUsage opts, StringSection target, PaddedAlignment aln, std::wstring_view overrunSymb)
 	{
 		DBG_ASSERT(opts.maxDecimals <= MaxFractionDigits);
@@ -336,24 +447,18 @@ namespace Utils::String
 			return false;
 		};
 
-		// Disable rounding, we want to consistently truncate here. Eg. Mach 0.95 != Mach 1.0
+		// Truncate always, we want to consistently truncate here. Eg. Mach 0.95 != Mach 1.0
 		// MAYBE: should be controllable via DecimalUsage - doing so would require manual rounding after truncation to stay consistent.
-		struct RoundModeGuard {
-			const int origMode = std::fegetround();
-			RoundModeGuard()   { std::fesetround(FE_TOWARDZERO); }
-			~RoundModeGuard()  { std::fesetround(origMode);	   }
-		} modeGuard;
-
-		const wchar_t* format = NonDefault(opts.sign & SignUsage::PrependPlus)
-			? L"%+.*f" 
-			: L"%.*f";
-
-		wchar_t num[PlaceDoubleMaxChars + 1];
-		int len = PrintTo(num, format, opts.maxDecimals, value);
-		if (len > 0)
+
+		// sign + whole digits (1 over the limit) + separator + fraction: checked against PlaceDoubleMaxChars after writing
+		wchar_t			num[1 + MaxWholeDigits + 1 + 1 + MaxFractionDigits];
+		wchar_t* const	end		  = num + std::size(num);
+		wchar_t*		start	  = end;
+		const size_t	wholePart = FormatTruncated(value, opts.maxDecimals, opts.sign, end, start);
+		if (wholePart > 0)
 		{
-			std::wstring_view unrounded { num, Cast::Implied<unsigned>(len) };
-			if (TryAlignDecimal(unrounded, target, aln, opts.preferDecimalsOverPadding))
+			std::wstring_view unrounded { start, Cast::Implied<size_t>(end - start) };
+			if (TryAlignDecimal(unrounded, wholePart, target, aln, opts.preferDecimalsOverPadding))
 				return true;
 		}
 		PlaceTruncableText(overrunSymb, target, aln);
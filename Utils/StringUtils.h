@@ -6,6 +6,8 @@
 	 *  Released under GPLv3.		   */
 
 
+#include <algorithm>
+#include <cstdint>
 #include <string>
 
 
@@ -46,7 +48,7 @@ namespace Utils::String
 		Default				 = 0,
 		PrependPlus			 = 1,
 		ForbidNegativeValues = 2,	// Simple solution to acute problems
-		//AvoidNegativeZero	 = 4	// MAYBE: if needed, more complicated
+		AvoidNegativeZero	 = 4	// e.g. -0.4 with 0 decimals: 0 instead of -0
 	};
 
 
@@ -74,15 +76,64 @@ namespace Utils::String
 
 
 
-	/// Modifiable part of a wstring buffer. Usually target of string operations.
+	/// Text line of at most @p Capacity characters, stored inline.
+	/// For display-sized lines: no heap use, and an array of them is a single block.
+	template <size_t Capacity>
+	class FixedLine {
+		static_assert (Capacity <= UINT8_MAX);
+
+		wchar_t		chars[Capacity];
+		uint8_t		length = 0;
+
+	public:
+		FixedLine() = default;
+		FixedLine(size_t count, wchar_t c)			{ Assign(count, c); }
+		FixedLine(std::wstring_view text)			{ Assign(text); }
+
+		size_t				Length()	   const	{ return length; }
+		wchar_t*			Data()					{ return chars; }
+		const wchar_t*		Data()		   const	{ return chars; }
+		std::wstring_view	AsStringView() const	{ return { chars, length }; }
+
+		/// Characters beyond Capacity are cut.
+		void Assign(std::wstring_view text)
+		{
+			length = static_cast<uint8_t>(std::min(text.length(), Capacity));
+			text.copy(chars, length);
+		}
+
+		void Assign(size_t count, wchar_t c)
+		{
+			length = static_cast<uint8_t>(std::min(count, Capacity));
+			std::fill_n(chars, length, c);
+		}
+	};
+
+
+
+	/// Modifiable part of a wchar_t buffer. Usually target of string operations.
 	struct StringSection {
-		std::wstring&	buffer;
+		wchar_t* const	buffer;
+		const size_t	bufferLength;
 		const size_t	Pos;
 		const size_t	Length;
 
+		StringSection(wchar_t* buffer, size_t bufferLength, size_t pos, size_t length);
 		StringSection(std::wstring& buffer, size_t pos, size_t length);
 		StringSection(std::wstring& buffer, size_t pos = 0);			// pos -> buffer end
 
+		template <size_t Capacity>
+		StringSection(FixedLine<Capacity>& line, size_t pos, size_t length) :
+			StringSection { line.Data(), line.Length(), pos, length }
+		{
+		}
+
+		template <size_t Capacity>
+		StringSection(FixedLine<Capacity>& line, size_t pos = 0) :
+			StringSection { line, pos, line.Length() - pos }
+		{
+		}
+
 		StringSection		FollowedBy(size_t length) const;
 		StringSection		SubSection(size_t offset, size_t length) const;
 
@@ -131,6 +182,10 @@ namespace Utils::String
 	/// @returns 	Did copy @src, as @p target had enough room for it.
 	bool	PlaceText(std::wstring_view src, StringSection target, PaddedAlignment);
 
+	/// Overloads for single-byte text: characters are widened one by one, like AsDumbWString.
+	size_t	PlaceTruncableText(std::string_view src, StringSection target, PaddedAlignment);
+	bool	PlaceText(std::string_view src, StringSection target, PaddedAlignment);
+
 
 
 	std::wstring AlignCenter(size_t lineLen, std::wstring_view text);
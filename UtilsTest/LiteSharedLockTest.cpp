@@ -195,6 +195,11 @@ namespace FSMfdTests
 			
 			TestContentionIntArray(llk);
 
+			Logger::WriteMessage("\nDistributedSharedLock:\n\n");
+
+			Utils::DistributedSharedLock dlk;
+			TestContentionIntArray(dlk);
+
 			Logger::WriteMessage("\nReference times with std::shared_mutex:\n\n");
 
 			std::shared_mutex referenceLk;
@@ -202,6 +207,84 @@ namespace FSMfdTests
 		}
 
 
+		TEST_METHOD(DistributedExclusiveness)
+		{
+			Utils::DistributedSharedLock lk;
+
+			lk.LockShared();
+			Assert::IsTrue(lk.TryLockShared());
+			lk.UnlockShared();
+
+			volatile bool flag = false;
+			std::thread thread { [&]()
+			{
+				lk.LockExclusive();
+				flag = true;
+				lk.UnlockExclusive();
+			} };
+			std::this_thread::sleep_for(10ms);
+			Assert::IsFalse(flag);
+
+			lk.UnlockShared();
+			thread.join();
+			Assert::IsTrue(flag);
+		}
+
+
+		// Read-mostly load: every 50th access writes.
+		TEST_METHOD(ScalingBenchmark)
+		{
+			for (size_t threads : { 1, 2, 4, 8, 16, 32, 64 })
+			{
+				std::stringstream msg;
+				msg << "\n" << threads << " threads:\n";
+				Logger::WriteMessage(msg.str().c_str());
+
+				LiteSharedLock				 lite;
+				Utils::DistributedSharedLock distributed;
+				std::shared_mutex			 reference;
+
+				MeasureReadMostly(lite,		   threads, "  LiteSharedLock:\t\t");
+				MeasureReadMostly(distributed, threads, "  DistributedSharedLock:\t");
+				MeasureReadMostly(reference,   threads, "  std::shared_mutex:\t\t");
+			}
+		}
+
+
+		template <class Lock>
+		static void MeasureReadMostly(Lock& lk, size_t threads, const char* title)
+		{
+			constexpr int AccessPerThread = 20000;
+			constexpr int WritePeriod	  = 50;
+
+			volatile long data = 0;
+			auto access = [&](size_t /*tid*/)
+			{
+				for (int i = 0; i < AccessPerThread; i++)
+				{
+					if (i % WritePeriod == 0)
+					{
+						std::unique_lock xguard { lk };
+						data = data + 1;
+					}
+					else
+					{
+						std::shared_lock guard { lk };
+						Assert::IsTrue(data >= 0);
+					}
+				}
+			};
+
+			auto tstart	 = Clock::now() + 50ms;
+			auto workers = SpawnThreadsSyncStart(threads, tstart, access);
+			Assert::IsTrue(WaitThreadsTimeout(workers, 20s));
+			LogDuration(title, Clock::now() - tstart);
+
+			const long writes = static_cast<long>(threads) * (AccessPerThread / WritePeriod);
+			Assert::AreEqual(writes, static_cast<long>(data));
+		}
+
+
 		template <class Lock>
 		static void TestContentionIntArray(Lock& lk)
 		{
@@ -5,6 +5,8 @@
 
 #include "Utils/StringUtils.h"
 #include "Utils/DoubleShorthands.h"
+#include <chrono>
+#include <sstream>
 
 
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
@@ -98,7 +100,7 @@ namespace FSMfdTests
 		for (size_t i = 0; i < s; i++)
 			Assert::AreEqual(filler, trg.buffer[i]);
 
-		for (size_t i = e; i < trg.buffer.length(); i++)
+		for (size_t i = e; i < trg.bufferLength; i++)
 			Assert::AreEqual(filler, trg.buffer[i]);
 	}
 
@@ -131,7 +133,7 @@ namespace FSMfdTests
 	template <class N, class... Args>
 	void AssertPlaceNum(N value, StringSection trg, std::wstring_view expectDigits, Args&&... placeExtras)
 	{
-		const size_t fullLen = trg.buffer.length();
+		const size_t fullLen = trg.bufferLength;
 
 		for (Align alnDir : { Align::Left, Align::Right })
 		{
@@ -142,12 +144,12 @@ namespace FSMfdTests
 
 				PaddedAlignment aln { alnDir, pad };
 
-				trg.buffer.assign(fullLen, L'X');
+				std::fill_n(trg.buffer, fullLen, L'X');
 
 				const bool shouldSucceed = IsPlaceable<N>(expectDigits, trg.Length);
 				Assert::AreEqual(shouldSucceed, PlaceNumber(value, placeExtras..., trg, aln));
 			
-				VERBOSE ('\t', trg.buffer.data(), L"    \tpad: ", aln.pad, L"\n");
+				VERBOSE ('\t', trg.buffer, L"    \tpad: ", aln.pad, L"\n");
 
 
 				if (shouldSucceed)
@@ -494,6 +496,111 @@ namespace FSMfdTests
 
 			Assert::IsFalse(PlaceNumber(-0.0, { 2, SignUsage::ForbidNegativeValues }, trg, Align::Right, L"n/a"));
 			Assert::AreEqual(L"  n/a", buff.c_str());
+
+			Assert::IsTrue(PlaceNumber(-0.4, { 0, SignUsage::AvoidNegativeZero }, trg));
+			Assert::AreEqual(L"    0", buff.c_str());
+			Assert::IsTrue(PlaceNumber(-0.004, { 2, SignUsage::PrependPlus | SignUsage::AvoidNegativeZero }, trg));
+			Assert::AreEqual(L"+0.00", buff.c_str());
+			Assert::IsTrue(PlaceNumber(-0.04, { 2, SignUsage::AvoidNegativeZero }, trg));
+			Assert::AreEqual(L"-0.04", buff.c_str());
+			Assert::IsTrue(PlaceNumber(-0.4, { 0 }, trg));
+			Assert::AreEqual(L"   -0", buff.c_str());
+		}
+
+
+		TEST_METHOD (PlaceNumber_DecimalsAsWritten)
+		{
+			std::wstring  buff(8, L' ');
+			StringSection trg { buff, 0 };
+
+			// 0.7 is stored as 0.69999..., 7.92 as 7.91999...
+			Assert::IsTrue(PlaceNumber(0.7, 1, trg));
+			Assert::AreEqual(L"     0.7", buff.c_str());
+			Assert::IsTrue(PlaceNumber(0.29, 2, trg));
+			Assert::AreEqual(L"    0.29", buff.c_str());
+			Assert::IsTrue(PlaceNumber(1.13, 2, trg));
+			Assert::AreEqual(L"    1.13", buff.c_str());
+			Assert::IsTrue(PlaceNumber(0.57, 3, trg));
+			Assert::AreEqual(L"   0.570", buff.c_str());
+			Assert::IsTrue(PlaceNumber(7.92, 5, trg));
+			Assert::AreEqual(L" 7.92000", buff.c_str());
+			Assert::IsTrue(PlaceNumber(-0.59, 2, trg));
+			Assert::AreEqual(L"   -0.59", buff.c_str());
+
+			// still truncating
+			Assert::IsTrue(PlaceNumber(0.95, 1, trg));
+			Assert::AreEqual(L"     0.9", buff.c_str());
+			Assert::IsTrue(PlaceNumber(0.999999, 2, trg));
+			Assert::AreEqual(L"    0.99", buff.c_str());
+
+			Assert::IsFalse(PlaceNumber(NaN, 2, trg));
+			Assert::AreEqual(L"      ##", buff.c_str());
+			Assert::IsFalse(PlaceNumber(Inf, 2, trg));
+			Assert::AreEqual(L"      ##", buff.c_str());
+		}
+
+
+		TEST_METHOD (PlaceText_Narrow)
+		{
+			std::wstring  buff(6, L'X');
+			StringSection trg { buff, 0 };
+
+			Assert::IsTrue(PlaceText(std::string_view { "N123" }, trg, Align::Right));
+			Assert::AreEqual(L"  N123", buff.c_str());
+			Assert::IsFalse(PlaceText(std::string_view { "N123ABC" }, trg, Align::Left));
+
+			Assert::AreEqual(size_t { 5 }, PlaceTruncableText(std::string_view { "N123ABC" }, trg, { Align::Left, 1 }));
+			Assert::AreEqual(L" N123A", buff.c_str());
+			Assert::AreEqual(size_t { 0 }, PlaceTruncableText(std::string_view {}, trg, Align::Left));
+			Assert::AreEqual(L"      ", buff.c_str());
+		}
+
+
+		TEST_METHOD (FixedLine_Sections)
+		{
+			FixedLine<8> line { L"TOO LONG TEXT" };
+			Assert::AreEqual(size_t { 8 }, line.Length());
+			Assert::IsTrue(line.AsStringView() == L"TOO LONG");
+
+			line.Assign(6, L' ');
+			StringSection trg { line, 2 };
+			Assert::IsTrue(PlaceNumber(42u, trg));
+			Assert::IsTrue(line.AsStringView() == L"    42");
+			Assert::IsTrue(PlaceText(L"AB", trg.SubSection(0, 2), Align::Left));
+			Assert::IsTrue(line.AsStringView() == L"  AB42");
+		}
+
+
+		// Printing a received value: the formatting hot path of gauges.
+		TEST_METHOD (PlaceBenchmark)
+		{
+			using Clock = std::chrono::high_resolution_clock;
+			constexpr int Rounds = 200'000;
+
+			std::wstring  buff(8, L' ');
+			StringSection trg { buff, 0 };
+
+			auto measure = [&](const char* title, auto&& place)
+			{
+				const auto start = Clock::now();
+				for (int i = 0; i < Rounds; i++)
+					place(i);
+				const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start);
+
+				std::stringstream msg;
+				msg << title << '\t' << ns.count() / Rounds << " ns/value\n";
+				Logger::WriteMessage(msg.str().c_str());
+			};
+
+			const std::string ident = "KSEA";
+
+			measure("uint32:        ", [&](int i) { PlaceNumber(static_cast<uint32_t>(i), trg); });
+			measure("int32:         ", [&](int i) { PlaceNumber(-i, trg); });
+			measure("double:        ", [&](int i) { PlaceNumber(i * 0.01, 2, trg); });
+			measure("text, narrow:  ", [&](int)   { PlaceText(std::string_view { ident }, trg, Align::Right); });
+			measure("text, widened: ", [&](int)   { PlaceText(AsDumbWString(ident), trg, Align::Right); });
+
+			Assert::AreEqual(L"    KSEA", buff.c_str());
 		}
 	};
 }